@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Гистограмма задержек в духе HdrHistogram: значения меньше 2 * kSubBuckets хранятся точно,
+// а каждый следующий интервал [2^k, 2^(k+1)) делится на kSubBuckets равных частей.
+// Относительная погрешность не больше 1 / kSubBuckets (меньше 1,6%) на всём диапазоне
+// uint64_t при фиксированном размере. Запись - O(1) без выделений памяти
+class LatencyHistogram {
+ public:
+  static constexpr unsigned kSubBucketBits = 6;
+  static constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBucketBits;
+
+  void Record(uint64_t value) noexcept {
+    ++counts_[IndexOf(value)];
+    ++total_count_;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    sum_ += value;
+  }
+
+  uint64_t GetTotalCount() const noexcept {
+    return total_count_;
+  }
+
+  uint64_t GetMin() const noexcept {
+    return total_count_ == 0 ? 0 : min_;
+  }
+
+  uint64_t GetMax() const noexcept {
+    return max_;
+  }
+
+  double GetMean() const noexcept {
+    return total_count_ == 0 ? 0 : static_cast<double>(sum_) / static_cast<double>(total_count_);
+  }
+
+  // Возвращает значение, которого не превышают percentile процентов записанных значений,
+  // с точностью до интервала. GetPercentile(100) равен точному максимуму
+  uint64_t GetPercentile(double percentile) const noexcept {
+    if (total_count_ == 0) {
+      return 0;
+    }
+    const double rank = std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(total_count_);
+    const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(rank + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      seen += counts_[i];
+      if (seen >= target) {
+        return std::min(HighestEquivalentValue(i), max_);
+      }
+    }
+    return max_;
+  }
+
+ private:
+  static constexpr size_t kBucketCount = (2 + 64 - kSubBucketBits - 1) * kSubBuckets;
+
+  static size_t IndexOf(uint64_t value) noexcept {
+    if (value < 2 * kSubBuckets) {
+      return static_cast<size_t>(value);
+    }
+    // После сдвига в значении остаются kSubBucketBits + 1 старших бит
+    const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - kSubBucketBits - 1;
+    return static_cast<size_t>((shift + 1) * kSubBuckets + (value >> shift) - kSubBuckets);
+  }
+
+  // Наибольшее значение, попадающее в интервал index
+  static uint64_t HighestEquivalentValue(size_t index) noexcept {
+    if (index < 2 * kSubBuckets) {
+      return index;
+    }
+    const unsigned shift = static_cast<unsigned>(index / kSubBuckets) - 1;
+    const uint64_t top = index % kSubBuckets + kSubBuckets;
+    return (top << shift) + ((uint64_t(1) << shift) - 1);
+  }
+
+  std::array<uint64_t, kBucketCount> counts_{};
+  uint64_t total_count_ = 0;
+  uint64_t min_ = std::numeric_limits<uint64_t>::max();
+  uint64_t max_ = 0;
+  uint64_t sum_ = 0;
+};
@@ -0,0 +1,690 @@
+// Сравнение операций SimpleVector с std::vector.
+// Каждая операция измеряется для int, std::string и перемещаемого, но не копируемого X
+// на размерах от 10 до SIMPLE_VECTOR_BENCHMARK_MAX_SIZE (для std::string и X - в 100 раз меньше).
+// Результаты в JSON: simple_vector_benchmark --benchmark_out=result.json --benchmark_out_format=json
+
+#include "concurrent_simple_vector.h"
+#include "cow_simple_vector.h"
+#include "gap_buffer.h"
+#include "parallel_algorithms.h"
+#include "segmented_vector.h"
+#include "simple_vector.h"
+#include "soa_vector.h"
+#include "vector_io.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef SIMPLE_VECTOR_BENCHMARK_MAX_SIZE
+#define SIMPLE_VECTOR_BENCHMARK_MAX_SIZE 100000000
+#endif
+
+namespace {
+
+// Тот же перемещаемый, но не копируемый тип, что и в тестах
+class X {
+ public:
+  X() : X(5) {
+  }
+  X(size_t num) : x_(num) {
+  }
+  X(const X &other) = delete;
+  X &operator=(const X &other) = delete;
+  X(X &&other) {
+    x_ = std::exchange(other.x_, 0);
+  }
+  X &operator=(X &&other) {
+    x_ = std::exchange(other.x_, 0);
+    return *this;
+  }
+  size_t GetX() const {
+    return x_;
+  }
+
+ private:
+  size_t x_;
+};
+
+template<typename Type>
+Type MakeValue(size_t i) {
+  if constexpr (std::is_same_v<Type, std::string>) {
+    // Строка длиннее буфера SSO, чтобы копирование выделяло память
+    return std::string(32, static_cast<char>('a' + i % 26));
+  } else {
+    return Type(i);
+  }
+}
+
+template<typename Type>
+size_t Weight(const Type &value) {
+  if constexpr (std::is_same_v<Type, std::string>) {
+    return value.size();
+  } else if constexpr (std::is_same_v<Type, X>) {
+    return value.GetX();
+  } else {
+    return static_cast<size_t>(value);
+  }
+}
+
+// Единый интерфейс к std::vector и SimpleVector
+
+template<typename Type>
+void PushBack(std::vector<Type> &v, Type &&value) {
+  v.push_back(std::move(value));
+}
+
+template<typename Type>
+void PushBack(SimpleVector<Type> &v, Type &&value) {
+  v.PushBack(std::move(value));
+}
+
+template<typename Type>
+void Insert(std::vector<Type> &v, size_t index, Type &&value) {
+  v.insert(v.begin() + index, std::move(value));
+}
+
+template<typename Type>
+void Insert(SimpleVector<Type> &v, size_t index, Type &&value) {
+  v.Insert(v.begin() + index, std::move(value));
+}
+
+template<typename Type>
+void Erase(std::vector<Type> &v, size_t index) {
+  v.erase(v.begin() + index);
+}
+
+template<typename Type>
+void Erase(SimpleVector<Type> &v, size_t index) {
+  v.Erase(v.begin() + index);
+}
+
+template<typename Type>
+void PopBack(std::vector<Type> &v) {
+  v.pop_back();
+}
+
+template<typename Type>
+void PopBack(SimpleVector<Type> &v) {
+  v.PopBack();
+}
+
+template<typename Type>
+void Reserve(std::vector<Type> &v, size_t capacity) {
+  v.reserve(capacity);
+}
+
+template<typename Type>
+void Reserve(SimpleVector<Type> &v, size_t capacity) {
+  v.Reserve(capacity);
+}
+
+template<typename Type>
+void Resize(std::vector<Type> &v, size_t size) {
+  v.resize(size);
+}
+
+template<typename Type>
+void Resize(SimpleVector<Type> &v, size_t size) {
+  v.Resize(size);
+}
+
+template<typename Vector>
+using ValueType = std::decay_t<decltype(*std::declval<Vector &>().begin())>;
+
+template<typename Vector>
+Vector MakeVector(size_t size) {
+  Vector v;
+  Reserve(v, size);
+  for (size_t i = 0; i < size; ++i) {
+    PushBack(v, MakeValue<ValueType<Vector>>(i));
+  }
+  return v;
+}
+
+// Заполнение пустого вектора PushBack, включая все перевыделения памяти
+template<typename Vector>
+void BM_PushBack(benchmark::State &state) {
+  const size_t size = state.range(0);
+  for (auto _ : state) {
+    Vector v;
+    for (size_t i = 0; i < size; ++i) {
+      PushBack(v, MakeValue<ValueType<Vector>>(i));
+    }
+    benchmark::DoNotOptimize(v.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+enum class Position { kFront, kMiddle, kBack };
+
+// Вставка одного элемента в вектор размера size.
+// После вставки удаляется последний элемент, чтобы размер не менялся
+template<typename Vector, Position position>
+void BM_Insert(benchmark::State &state) {
+  const size_t size = state.range(0);
+  auto v = MakeVector<Vector>(size);
+  Reserve(v, size + 1);
+  const size_t index = position == Position::kFront ? 0 : position == Position::kMiddle ? size / 2 : size;
+  for (auto _ : state) {
+    Insert(v, index, MakeValue<ValueType<Vector>>(size));
+    PopBack(v);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Удаление элемента из середины вектора размера size.
+// После удаления элемент добавляется в конец, чтобы размер не менялся
+template<typename Vector>
+void BM_Erase(benchmark::State &state) {
+  const size_t size = state.range(0);
+  auto v = MakeVector<Vector>(size);
+  for (auto _ : state) {
+    Erase(v, size / 2);
+    PushBack(v, MakeValue<ValueType<Vector>>(size));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Увеличение вместимости вдвое у вектора из size элементов: одно выделение памяти
+// и перенос всех элементов
+template<typename Vector>
+void BM_Reserve(benchmark::State &state) {
+  const size_t size = state.range(0);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto v = MakeVector<Vector>(size);
+    state.ResumeTiming();
+    Reserve(v, size * 2);
+    benchmark::DoNotOptimize(v.begin());
+    state.PauseTiming();
+    v = Vector();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+template<typename Vector>
+void BM_Copy(benchmark::State &state) {
+  const size_t size = state.range(0);
+  const auto source = MakeVector<Vector>(size);
+  for (auto _ : state) {
+    Vector copy(source);
+    benchmark::DoNotOptimize(copy.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Копирующее присваивание в один и тот же вектор: после первой итерации
+// вместимости хватает, и память не выделяется
+template<typename Vector>
+void BM_CopyAssign(benchmark::State &state) {
+  const size_t size = state.range(0);
+  const auto source = MakeVector<Vector>(size);
+  Vector scratch;
+  for (auto _ : state) {
+    scratch = source;
+    benchmark::DoNotOptimize(scratch.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Перемещающий конструктор и перемещающее присваивание не зависят от размера
+template<typename Vector>
+void BM_Move(benchmark::State &state) {
+  const size_t size = state.range(0);
+  auto v = MakeVector<Vector>(size);
+  for (auto _ : state) {
+    Vector moved(std::move(v));
+    v = std::move(moved);
+    benchmark::DoNotOptimize(v.begin());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Увеличение размера пустого вектора до size элементов по умолчанию
+template<typename Vector>
+void BM_Resize(benchmark::State &state) {
+  const size_t size = state.range(0);
+  for (auto _ : state) {
+    Vector v;
+    Resize(v, size);
+    benchmark::DoNotOptimize(v.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Раздача снимка вектора из size элементов четырём читателям: SimpleVector копируется
+// целиком, CowSimpleVector только увеличивает счётчик ссылок
+template<typename Vector>
+void BM_SnapshotFanOut(benchmark::State &state) {
+  const size_t size = state.range(0);
+  Vector source(size, 1);
+  for (auto _ : state) {
+    for (int reader = 0; reader < 4; ++reader) {
+      Vector snapshot = source;
+      benchmark::DoNotOptimize(snapshot.GetSize());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 4);
+}
+
+// Чтение size байт в буфер (имитируется memcpy): буфер сначала увеличивается
+// до size с обнулением (Resize) или без него (ResizeUninitialized)
+template<bool uninitialized>
+void BM_ReadIntoBuffer(benchmark::State &state) {
+  const size_t size = state.range(0);
+  const std::vector<uint8_t> source(size, 1);
+  SimpleVector<uint8_t> buffer;
+  buffer.Reserve(size);
+  for (auto _ : state) {
+    buffer.Clear();
+    if constexpr (uninitialized) {
+      buffer.ResizeUninitialized(size);
+    } else {
+      buffer.Resize(size);
+    }
+    std::memcpy(buffer.Data(), source.data(), size);
+    benchmark::DoNotOptimize(buffer.Data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+// Запись четырёх буферов по size байт в /dev/null: четыре вызова write
+// в сравнении с одним writev
+template<bool vectored>
+void BM_WriteBuffers(benchmark::State &state) {
+  const size_t size = state.range(0);
+  const SimpleVector<char> a(size, 'a'), b(size, 'b'), c(size, 'c'), d(size, 'd');
+  const int fd = ::open("/dev/null", O_WRONLY);
+  for (auto _ : state) {
+    if constexpr (vectored) {
+      benchmark::DoNotOptimize(WriteVectored(fd, a, b, c, d));
+    } else {
+      for (const auto *buffer : {&a, &b, &c, &d}) {
+        benchmark::DoNotOptimize(::write(fd, buffer->Data(), buffer->GetSize()));
+      }
+    }
+  }
+  ::close(fd);
+  state.SetBytesProcessed(state.iterations() * size * 4);
+}
+
+template<typename Vector>
+void BM_Iteration(benchmark::State &state) {
+  const size_t size = state.range(0);
+  const auto v = MakeVector<Vector>(size);
+  for (auto _ : state) {
+    size_t sum = 0;
+    for (const auto &value : v) {
+      sum += Weight(value);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Сравнение векторов размера size, которые различаются только последним элементом
+template<typename Vector>
+std::pair<Vector, Vector> MakeAlmostEqualVectors(size_t size) {
+  auto lhs = MakeVector<Vector>(size);
+  auto rhs = lhs;
+  rhs[size - 1] = static_cast<ValueType<Vector>>(rhs[size - 1] + 1);
+  return {std::move(lhs), std::move(rhs)};
+}
+
+template<typename Vector>
+void BM_Equal(benchmark::State &state) {
+  const auto [lhs, rhs] = MakeAlmostEqualVectors<Vector>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lhs == rhs);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(ValueType<Vector>));
+}
+
+template<typename Vector>
+void BM_Less(benchmark::State &state) {
+  const auto [lhs, rhs] = MakeAlmostEqualVectors<Vector>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lhs < rhs);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(ValueType<Vector>));
+}
+
+template<typename Vector>
+void RegisterComparison(const std::string &container, const std::string &type, int64_t max_size) {
+  const std::string suffix = "/" + container + "<" + type + ">";
+  benchmark::RegisterBenchmark(("Equal" + suffix).c_str(), BM_Equal<Vector>)->RangeMultiplier(10)->Range(10, max_size);
+  benchmark::RegisterBenchmark(("Less" + suffix).c_str(), BM_Less<Vector>)->RangeMultiplier(10)->Range(10, max_size);
+}
+
+template<typename Type>
+void RegisterComparisonType(const std::string &type, int64_t max_size) {
+  RegisterComparison<std::vector<Type>>("std::vector", type, max_size);
+  RegisterComparison<SimpleVector<Type>>("SimpleVector", type, max_size);
+}
+
+// Поэлементная обработка SimpleVector<float>: данные выровнены аллокатором по умолчанию
+// или по кэш-линии AlignedAllocator и объявлены компилятору через AlignedData()
+template<typename Vector>
+void BM_NegateFloat(benchmark::State &state) {
+  const size_t size = state.range(0);
+  Vector v(size, 1.0f);
+  for (auto _ : state) {
+    float *data = v.AlignedData();
+    for (size_t i = 0; i < size; ++i) {
+      data[i] = -data[i];
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * size * sizeof(float));
+}
+
+// Заполнение вектора int через PushBack с замером самого долгого добавления:
+// у SimpleVector это перенос всех элементов при перевыделении, у SegmentedVector -
+// выделение очередного блока. Аргумент - число элементов
+template<typename Vector>
+void BM_PushBackMaxLatency(benchmark::State &state) {
+  const size_t size = state.range(0);
+  double max_latency_ns = 0;
+  for (auto _ : state) {
+    Vector v;
+    for (size_t i = 0; i < size; ++i) {
+      const auto start = std::chrono::steady_clock::now();
+      v.PushBack(static_cast<int>(i));
+      const auto finish = std::chrono::steady_clock::now();
+      max_latency_ns = std::max(max_latency_ns, std::chrono::duration<double, std::nano>(finish - start).count());
+    }
+    benchmark::DoNotOptimize(&v[0]);
+  }
+  state.counters["max_push_ns"] = max_latency_ns;
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Правки в текстовом буфере из size символов: курсор идёт от середины, на каждой
+// позиции вставляется символ и удаляется следующий, так что размер не меняется.
+// SimpleVector сдвигает весь хвост, GapBuffer - только разрыв на одну позицию
+
+template<typename Buffer>
+void BM_EditAtCursor(benchmark::State &state) {
+  const size_t size = state.range(0);
+  Buffer text;
+  for (size_t i = 0; i < size; ++i) {
+    text.PushBack(static_cast<char>('a' + i % 26));
+  }
+  size_t cursor = size / 2;
+  for (auto _ : state) {
+    text.Insert(text.begin() + cursor, 'x');
+    text.Erase(text.begin() + cursor + 1);
+    if (++cursor == size) {
+      cursor = 0;
+    }
+  }
+  benchmark::DoNotOptimize(text[0]);
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Сумма одного поля записей: SimpleVector структур (AoS) в сравнении с массивом поля
+// SoAVector. Аргумент - число записей
+
+struct Record {
+  double x;
+  double y;
+  double z;
+  int64_t id;
+};
+
+void BM_SumFieldAoS(benchmark::State &state) {
+  SimpleVector<Record> records;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    records.PushBack(Record{static_cast<double>(i), 0, 0, i});
+  }
+  for (auto _ : state) {
+    double sum = 0;
+    for (const Record &record : records) {
+      sum += record.x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_SumFieldSoA(benchmark::State &state) {
+  AlignedSoAVector<double, double, double, int64_t> records;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    records.PushBack({static_cast<double>(i), 0, 0, i});
+  }
+  for (auto _ : state) {
+    double sum = 0;
+    for (double x : records.Column<0>()) {
+      sum += x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Добавление элементов из нескольких потоков: SimpleVector под мьютексом
+// в сравнении с ConcurrentSimpleVector. Число потоков задаёт Threads
+
+void BM_LockedPushBack(benchmark::State &state) {
+  static std::mutex mutex;
+  static SimpleVector<int> v;
+  if (state.thread_index() == 0) {
+    v.Reset();
+  }
+  for (auto _ : state) {
+    std::lock_guard lock(mutex);
+    v.PushBack(1);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ConcurrentPushBack(benchmark::State &state) {
+  static ConcurrentSimpleVector<int> v;
+  if (state.thread_index() == 0) {
+    v.Clear();
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(v.PushBack(1));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Параллельные алгоритмы над SimpleVector<int> в сравнении с последовательными.
+// Аргумент - размер вектора
+
+void BM_SerialReduce(benchmark::State &state) {
+  const auto v = MakeVector<SimpleVector<int>>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::accumulate(v.begin(), v.end(), int64_t{0}));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ParallelReduce(benchmark::State &state) {
+  const auto v = MakeVector<SimpleVector<int>>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ParallelReduce(v, int64_t{0}));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_SerialForEach(benchmark::State &state) {
+  auto v = MakeVector<SimpleVector<int>>(state.range(0));
+  for (auto _ : state) {
+    std::for_each(v.begin(), v.end(), [](int &x) {
+      x = x * 3 + 1;
+    });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ParallelForEach(benchmark::State &state) {
+  auto v = MakeVector<SimpleVector<int>>(state.range(0));
+  for (auto _ : state) {
+    ParallelForEach(v, [](int &x) {
+      x = x * 3 + 1;
+    });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<bool parallel>
+void BM_Sort(benchmark::State &state) {
+  const size_t size = state.range(0);
+  auto v = MakeVector<SimpleVector<int>>(size);
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (size_t i = 0; i < size; ++i) {
+      v[i] = static_cast<int>(i * 2654435761u);
+    }
+    state.ResumeTiming();
+    if constexpr (parallel) {
+      ParallelSort(v);
+    } else {
+      std::sort(v.begin(), v.end());
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Создание вектора из size элементов и его копирование, последовательно или параллельно
+template<bool parallel>
+void BM_FillConstruct(benchmark::State &state) {
+  const size_t size = state.range(0);
+  for (auto _ : state) {
+    if constexpr (parallel) {
+      SimpleVector<int> v(ParallelInit(), size, 1);
+      benchmark::DoNotOptimize(v.begin());
+    } else {
+      SimpleVector<int> v(size, 1);
+      benchmark::DoNotOptimize(v.begin());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+template<bool parallel>
+void BM_CopyConstruct(benchmark::State &state) {
+  const size_t size = state.range(0);
+  const auto source = MakeVector<SimpleVector<int>>(size);
+  for (auto _ : state) {
+    if constexpr (parallel) {
+      SimpleVector<int> copy(ParallelInit(), source);
+      benchmark::DoNotOptimize(copy.begin());
+    } else {
+      SimpleVector<int> copy(source);
+      benchmark::DoNotOptimize(copy.begin());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+void RegisterParallel(int64_t max_size) {
+  using NamedBenchmark = std::pair<const char *, void (*)(benchmark::State &)>;
+  for (auto [name, function] : {NamedBenchmark{"SerialReduce", BM_SerialReduce},
+                                NamedBenchmark{"ParallelReduce", BM_ParallelReduce},
+                                NamedBenchmark{"SerialForEach", BM_SerialForEach},
+                                NamedBenchmark{"ParallelForEach", BM_ParallelForEach},
+                                NamedBenchmark{"SerialSort", BM_Sort<false>},
+                                NamedBenchmark{"ParallelSort", BM_Sort<true>},
+                                NamedBenchmark{"SerialFillConstruct", BM_FillConstruct<false>},
+                                NamedBenchmark{"ParallelFillConstruct", BM_FillConstruct<true>},
+                                NamedBenchmark{"SerialCopyConstruct", BM_CopyConstruct<false>},
+                                NamedBenchmark{"ParallelCopyConstruct", BM_CopyConstruct<true>}}) {
+    benchmark::RegisterBenchmark(name, function)->RangeMultiplier(10)->Range(10000, max_size)->UseRealTime();
+  }
+}
+
+void Register(const std::string &name, void (*function)(benchmark::State &), int64_t max_size) {
+  benchmark::RegisterBenchmark(name.c_str(), function)->RangeMultiplier(10)->Range(10, max_size);
+}
+
+template<typename Vector>
+void RegisterContainer(const std::string &container, const std::string &type, int64_t max_size) {
+  const std::string suffix = "/" + container + "<" + type + ">";
+  Register("PushBack" + suffix, BM_PushBack<Vector>, max_size);
+  Register("InsertFront" + suffix, BM_Insert<Vector, Position::kFront>, max_size);
+  Register("InsertMiddle" + suffix, BM_Insert<Vector, Position::kMiddle>, max_size);
+  Register("InsertBack" + suffix, BM_Insert<Vector, Position::kBack>, max_size);
+  Register("Erase" + suffix, BM_Erase<Vector>, max_size);
+  Register("Reserve" + suffix, BM_Reserve<Vector>, max_size);
+  if constexpr (std::is_copy_constructible_v<ValueType<Vector>>) {
+    Register("Copy" + suffix, BM_Copy<Vector>, max_size);
+    Register("CopyAssign" + suffix, BM_CopyAssign<Vector>, max_size);
+  }
+  Register("Move" + suffix, BM_Move<Vector>, max_size);
+  Register("Resize" + suffix, BM_Resize<Vector>, max_size);
+  Register("Iteration" + suffix, BM_Iteration<Vector>, max_size);
+}
+
+template<typename Type>
+void RegisterType(const std::string &type, int64_t max_size) {
+  RegisterContainer<std::vector<Type>>("std::vector", type, max_size);
+  RegisterContainer<SimpleVector<Type>>("SimpleVector", type, max_size);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  constexpr int64_t kMaxSize = SIMPLE_VECTOR_BENCHMARK_MAX_SIZE;
+  RegisterType<int>("int", kMaxSize);
+  RegisterType<std::string>("string", std::max<int64_t>(kMaxSize / 100, 10));
+  RegisterType<X>("X", std::max<int64_t>(kMaxSize / 100, 10));
+  RegisterParallel(std::max<int64_t>(kMaxSize, 10000));
+  benchmark::RegisterBenchmark("NegateFloat/SimpleVector", BM_NegateFloat<SimpleVector<float>>)
+      ->RangeMultiplier(10)->Range(1000, kMaxSize);
+  benchmark::RegisterBenchmark("NegateFloat/AlignedSimpleVector", BM_NegateFloat<AlignedSimpleVector<float>>)
+      ->RangeMultiplier(10)->Range(1000, kMaxSize);
+  RegisterComparisonType<int>("int", kMaxSize);
+  RegisterComparisonType<uint8_t>("uint8_t", kMaxSize);
+  benchmark::RegisterBenchmark("LockedPushBack", BM_LockedPushBack)->ThreadRange(1, 8)->UseRealTime();
+  benchmark::RegisterBenchmark("ConcurrentPushBack", BM_ConcurrentPushBack)->ThreadRange(1, 8)->UseRealTime();
+  benchmark::RegisterBenchmark("EditAtCursor/SimpleVector", BM_EditAtCursor<SimpleVector<char>>)
+      ->RangeMultiplier(10)->Range(1000, kMaxSize);
+  benchmark::RegisterBenchmark("EditAtCursor/GapBuffer", BM_EditAtCursor<GapBuffer<char>>)
+      ->RangeMultiplier(10)->Range(1000, kMaxSize);
+  benchmark::RegisterBenchmark("ReadIntoBuffer/Resize", BM_ReadIntoBuffer<false>)
+      ->RangeMultiplier(10)->Range(1000, kMaxSize);
+  benchmark::RegisterBenchmark("ReadIntoBuffer/ResizeUninitialized", BM_ReadIntoBuffer<true>)
+      ->RangeMultiplier(10)->Range(1000, kMaxSize);
+  benchmark::RegisterBenchmark("WriteBuffers/write", BM_WriteBuffers<false>)->RangeMultiplier(8)->Range(64, 4096);
+  benchmark::RegisterBenchmark("WriteBuffers/writev", BM_WriteBuffers<true>)->RangeMultiplier(8)->Range(64, 4096);
+  benchmark::RegisterBenchmark("SnapshotFanOut/SimpleVector", BM_SnapshotFanOut<SimpleVector<int>>)
+      ->RangeMultiplier(100)->Range(100, kMaxSize);
+  benchmark::RegisterBenchmark("SnapshotFanOut/CowSimpleVector", BM_SnapshotFanOut<CowSimpleVector<int>>)
+      ->RangeMultiplier(100)->Range(100, kMaxSize);
+  benchmark::RegisterBenchmark("SumField/AoS", BM_SumFieldAoS)->RangeMultiplier(10)->Range(1000, kMaxSize);
+  benchmark::RegisterBenchmark("SumField/SoA", BM_SumFieldSoA)->RangeMultiplier(10)->Range(1000, kMaxSize);
+  benchmark::RegisterBenchmark("PushBackMaxLatency/SimpleVector", BM_PushBackMaxLatency<SimpleVector<int>>)
+      ->RangeMultiplier(10)->Range(1000000, std::max<int64_t>(kMaxSize, 1000000));
+  benchmark::RegisterBenchmark("PushBackMaxLatency/SegmentedVector", BM_PushBackMaxLatency<SegmentedVector<int>>)
+      ->RangeMultiplier(10)->Range(1000000, std::max<int64_t>(kMaxSize, 1000000));
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
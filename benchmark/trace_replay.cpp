@@ -0,0 +1,269 @@
+// Воспроизведение записанной последовательности операций SimpleVector<int> с замером
+// каждой операции. Для каждого вида операций выводится гистограмма задержек (см. latency_histogram.h),
+// а политика TracingInstrumentation отдельно сообщает о перевыделениях памяти
+// и сдвигах хвоста, из которых и складываются выбросы p99.9.
+//
+// Трасса - текстовый файл, по одной операции в строке; строки с # пропускаются:
+//   push_back <value>
+//   reserve <capacity>
+//   resize <size>
+//   insert <index> <count> <value>   - индекс ограничивается размером вектора
+//   erase <index> <count>            - удаляемый диапазон ограничивается концом вектора
+//   shrink_to_fit
+//   clear
+//
+// Использование:
+//   simple_vector_trace_replay <trace|-> [repeat]   - воспроизвести трассу repeat раз
+//   simple_vector_trace_replay --generate <count> [seed]
+//                                                   - вывести случайную трассу из count операций
+
+#include "latency_histogram.h"
+
+#include "instrumentation.h"
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class OperationKind {
+  kPushBack,
+  kReserve,
+  kResize,
+  kInsert,
+  kErase,
+  kShrinkToFit,
+  kClear,
+};
+
+constexpr const char *kOperationNames[] = {"push_back", "reserve", "resize", "insert", "erase",
+                                           "shrink_to_fit", "clear"};
+constexpr size_t kOperationCount = std::size(kOperationNames);
+
+struct Operation {
+  OperationKind kind;
+  size_t first = 0;
+  size_t second = 0;
+  int value = 0;
+};
+
+// Читает трассу. Бросает std::runtime_error с номером строки, если строка не разобрана
+std::vector<Operation> ReadTrace(std::istream &in) {
+  std::vector<Operation> trace;
+  std::string line;
+  for (size_t line_number = 1; std::getline(in, line); ++line_number) {
+    std::istringstream fields(line);
+    std::string name;
+    if (!(fields >> name) || name[0] == '#') {
+      continue;
+    }
+    const auto found = std::find(std::begin(kOperationNames), std::end(kOperationNames), name);
+    if (found == std::end(kOperationNames)) {
+      throw std::runtime_error("line " + std::to_string(line_number) + ": unknown operation " + name);
+    }
+    Operation operation{static_cast<OperationKind>(found - std::begin(kOperationNames))};
+    bool parsed = true;
+    switch (operation.kind) {
+      case OperationKind::kPushBack:
+        parsed = static_cast<bool>(fields >> operation.value);
+        break;
+      case OperationKind::kReserve:
+      case OperationKind::kResize:
+        parsed = static_cast<bool>(fields >> operation.first);
+        break;
+      case OperationKind::kInsert:
+        parsed = static_cast<bool>(fields >> operation.first >> operation.second >> operation.value);
+        break;
+      case OperationKind::kErase:
+        parsed = static_cast<bool>(fields >> operation.first >> operation.second);
+        break;
+      case OperationKind::kShrinkToFit:
+      case OperationKind::kClear:
+        break;
+    }
+    if (!parsed) {
+      throw std::runtime_error("line " + std::to_string(line_number) + ": bad arguments for " + name);
+    }
+    trace.push_back(operation);
+  }
+  return trace;
+}
+
+// Случайная трасса, похожая на буфер, который в основном растёт с конца:
+// вставки и удаления в случайных местах, изредка резервирование, сжатие и очистка
+void GenerateTrace(std::ostream &out, size_t count, uint64_t seed) {
+  std::mt19937_64 random(seed);
+  size_t size = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const auto roll = random() % 1000;
+    const size_t index = size == 0 ? 0 : random() % (size + 1);
+    if (roll < 900) {
+      out << "push_back " << i << '\n';
+      ++size;
+    } else if (roll < 950) {
+      const size_t inserted = 1 + random() % 4;
+      out << "insert " << index << ' ' << inserted << ' ' << i << '\n';
+      size += inserted;
+    } else if (roll < 990) {
+      out << "erase " << index << " 1\n";
+      size -= index < size ? 1 : 0;
+    } else if (roll < 995) {
+      out << "reserve " << size * 2 << '\n';
+    } else if (roll < 998) {
+      out << "resize " << size / 2 << '\n';
+      size /= 2;
+    } else if (roll < 999) {
+      out << "shrink_to_fit\n";
+    } else {
+      out << "clear\n";
+      size = 0;
+    }
+  }
+}
+
+using TracedVector = SimpleVector<int, std::allocator<int>, DoublingGrowth, TracingInstrumentation>;
+
+// События TracingInstrumentation за время воспроизведения
+struct TraceStatistics {
+  LatencyHistogram reallocations;
+  LatencyHistogram reallocated_bytes;
+  LatencyHistogram shifted_bytes;
+};
+
+void CollectEvent(const TraceEvent &event, void *context) {
+  auto &statistics = *static_cast<TraceStatistics *>(context);
+  if (event.kind == TraceEvent::Kind::kReallocation) {
+    statistics.reallocations.Record(static_cast<uint64_t>(event.duration.count()));
+    statistics.reallocated_bytes.Record(event.bytes);
+  } else {
+    statistics.shifted_bytes.Record(event.bytes);
+  }
+}
+
+void Apply(TracedVector &v, const Operation &operation) {
+  switch (operation.kind) {
+    case OperationKind::kPushBack:
+      v.PushBack(operation.value);
+      break;
+    case OperationKind::kReserve:
+      v.Reserve(operation.first);
+      break;
+    case OperationKind::kResize:
+      v.Resize(operation.first);
+      break;
+    case OperationKind::kInsert:
+      v.Insert(v.begin() + std::min(operation.first, v.GetSize()), operation.second, operation.value);
+      break;
+    case OperationKind::kErase: {
+      const size_t first = std::min(operation.first, v.GetSize());
+      const size_t last = first + std::min(operation.second, v.GetSize() - first);
+      v.Erase(v.begin() + first, v.begin() + last);
+      break;
+    }
+    case OperationKind::kShrinkToFit:
+      v.ShrinkToFit();
+      break;
+    case OperationKind::kClear:
+      v.Clear();
+      break;
+  }
+}
+
+void PrintHeader(std::ostream &out, const char *unit) {
+  out << std::left << std::setw(16) << unit << std::right;
+  for (const char *column : {"count", "min", "mean", "p50", "p90", "p99", "p99.9", "max"}) {
+    out << std::setw(12) << column;
+  }
+  out << '\n';
+}
+
+void PrintRow(std::ostream &out, const std::string &name, const LatencyHistogram &histogram) {
+  out << std::left << std::setw(16) << name << std::right
+      << std::setw(12) << histogram.GetTotalCount()
+      << std::setw(12) << histogram.GetMin()
+      << std::setw(12) << std::fixed << std::setprecision(0) << histogram.GetMean();
+  for (double percentile : {50.0, 90.0, 99.0, 99.9, 100.0}) {
+    out << std::setw(12) << histogram.GetPercentile(percentile);
+  }
+  out << '\n';
+}
+
+int Replay(std::istream &in, size_t repeat) {
+  const std::vector<Operation> trace = ReadTrace(in);
+  std::vector<LatencyHistogram> latencies(kOperationCount);
+  TraceStatistics statistics;
+  TracingInstrumentation::SetHandler(CollectEvent, &statistics);
+  for (size_t i = 0; i < repeat; ++i) {
+    TracedVector v;
+    for (const Operation &operation : trace) {
+      const auto start = std::chrono::steady_clock::now();
+      Apply(v, operation);
+      const auto finish = std::chrono::steady_clock::now();
+      latencies[static_cast<size_t>(operation.kind)].Record(
+          static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count()));
+    }
+  }
+  TracingInstrumentation::SetHandler(nullptr);
+
+  PrintHeader(std::cout, "operation, ns");
+  for (size_t kind = 0; kind < kOperationCount; ++kind) {
+    if (latencies[kind].GetTotalCount() != 0) {
+      PrintRow(std::cout, kOperationNames[kind], latencies[kind]);
+    }
+  }
+  PrintRow(std::cout, "reallocation", statistics.reallocations);
+  std::cout << '\n';
+  PrintHeader(std::cout, "moved, bytes");
+  PrintRow(std::cout, "reallocation", statistics.reallocated_bytes);
+  PrintRow(std::cout, "large shift", statistics.shifted_bytes);
+  return 0;
+}
+
+int PrintUsage() {
+  std::cerr << "usage: simple_vector_trace_replay <trace|-> [repeat]\n"
+               "       simple_vector_trace_replay --generate <count> [seed]\n";
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 4) {
+    return PrintUsage();
+  }
+  try {
+    const std::string command = argv[1];
+    if (command == "--generate") {
+      if (argc < 3) {
+        return PrintUsage();
+      }
+      GenerateTrace(std::cout, std::stoull(argv[2]), argc > 3 ? std::stoull(argv[3]) : 1);
+      return 0;
+    }
+    const size_t repeat = argc > 2 ? std::stoull(argv[2]) : 1;
+    if (command == "-") {
+      return Replay(std::cin, repeat);
+    }
+    std::ifstream in(command);
+    if (!in) {
+      std::cerr << "cannot open " << command << '\n';
+      return 1;
+    }
+    return Replay(in, repeat);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+}
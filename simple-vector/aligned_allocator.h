@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Аллокатор, выделяющий память с выравниванием Alignment байт (по умолчанию - по кэш-линии).
+// Так данные вектора начинаются с границы кэш-линии или SIMD-регистра,
+// и векторизованные циклы обходятся без невыровненных загрузок
+template<typename Type, size_t Alignment = 64>
+class AlignedAllocator {
+  static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+  static_assert(Alignment >= alignof(Type), "Alignment must not be weaker than alignof(Type)");
+
+ public:
+  using value_type = Type;
+  using is_always_equal = std::true_type;
+
+  static constexpr size_t kAlignment = Alignment;
+
+  template<typename Other>
+  struct rebind {
+    using other = AlignedAllocator<Other, Alignment>;
+  };
+
+  AlignedAllocator() noexcept = default;
+
+  template<typename Other>
+  AlignedAllocator(const AlignedAllocator<Other, Alignment> &) noexcept {
+  }
+
+  Type *allocate(size_t size) {
+    if (size > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<Type *>(::operator new(size * sizeof(Type), std::align_val_t{Alignment}));
+  }
+
+  void deallocate(Type *ptr, size_t size) noexcept {
+    ::operator delete(ptr, size * sizeof(Type), std::align_val_t{Alignment});
+  }
+};
+
+template<typename Type, typename Other, size_t Alignment>
+bool operator==(const AlignedAllocator<Type, Alignment> &, const AlignedAllocator<Other, Alignment> &) noexcept {
+  return true;
+}
+
+template<typename Type, typename Other, size_t Alignment>
+bool operator!=(const AlignedAllocator<Type, Alignment> &, const AlignedAllocator<Other, Alignment> &) noexcept {
+  return false;
+}
+
+namespace detail {
+
+template<typename Allocator, typename = void>
+struct AllocatorAlignment
+    : std::integral_constant<size_t, alignof(typename std::allocator_traits<Allocator>::value_type)> {
+};
+
+template<typename Allocator>
+struct AllocatorAlignment<Allocator, std::void_t<decltype(Allocator::kAlignment)>>
+    : std::integral_constant<size_t, Allocator::kAlignment> {
+};
+
+// Выравнивание, которое аллокатор гарантирует для выделенной памяти
+template<typename Allocator>
+inline constexpr size_t kAllocatorAlignment = AllocatorAlignment<Allocator>::value;
+
+}  // namespace detail
+
+// Сообщает компилятору, что ptr выровнен по Alignment байт, чтобы он мог
+// использовать выровненные загрузки при векторизации циклов
+template<size_t Alignment, typename Type>
+Type *AssumeAligned(Type *ptr) noexcept {
+#if defined(__cpp_lib_assume_aligned)
+  return std::assume_aligned<Alignment>(ptr);
+#elif defined(__GNUC__)
+  return static_cast<Type *>(__builtin_assume_aligned(ptr, Alignment));
+#else
+  return ptr;
+#endif
+}
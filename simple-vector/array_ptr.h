@@ -1,62 +1,158 @@
+#pragma once
+
+#include <cassert>
 #include <cstdlib>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
-template<typename Type>
+#include "config.h"
+
+// Владеет неинициализированной памятью под массив элементов типа Type.
+// ArrayPtr только выделяет и освобождает память через Allocator: объекты в ней
+// не создаются и не разрушаются - за это отвечает владелец (например, SimpleVector)
+template<typename Type, typename Allocator = std::allocator<Type>>
 class ArrayPtr {
+  using AllocTraits = std::allocator_traits<Allocator>;
+
+  static_assert(std::is_same_v<typename AllocTraits::value_type, Type>,
+                "Allocator::value_type must be the same as Type");
+  static_assert(std::is_same_v<typename AllocTraits::pointer, Type *>,
+                "Allocator must use raw pointers");
+
  public:
   // Инициализирует ArrayPtr нулевым указателем
-  ArrayPtr() = default;
+  constexpr ArrayPtr() = default;
 
-  // Создаёт в куче массив из size элементов типа Type.
+  // Инициализирует ArrayPtr нулевым указателем и запоминает аллокатор
+  SIMPLE_VECTOR_CONSTEXPR explicit ArrayPtr(const Allocator &alloc) noexcept : alloc_(alloc) {
+  }
+
+  // Выделяет через аллокатор неинициализированную память под size элементов типа Type.
   // Если size == 0, поле raw_ptr_ должно быть равно nullptr
-  explicit ArrayPtr(size_t size) {
-    raw_ptr_ = size ? new Type[size] : nullptr;
+  SIMPLE_VECTOR_CONSTEXPR explicit ArrayPtr(size_t size, const Allocator &alloc = Allocator()) : alloc_(alloc) {
+    raw_ptr_ = size ? AllocTraits::allocate(alloc_, size) : nullptr;
+    size_ = size;
   }
 
-  // Конструктор из сырого указателя, хранящего адрес массива в куче либо nullptr
-  explicit ArrayPtr(Type *raw_ptr) noexcept: raw_ptr_(raw_ptr) {}
+  // Конструктор из сырого указателя, хранящего адрес памяти под size элементов,
+  // ранее выделенной аллокатором alloc (см. Release), либо nullptr
+  SIMPLE_VECTOR_CONSTEXPR ArrayPtr(Type *raw_ptr, size_t size, const Allocator &alloc = Allocator()) noexcept
+      : alloc_(alloc), raw_ptr_(raw_ptr), size_(raw_ptr ? size : 0) {
+  }
 
   // Запрещаем копирование
   ArrayPtr(const ArrayPtr &) = delete;
 
-  ~ArrayPtr() {
-    delete[] raw_ptr_;
+  // Забирает память и аллокатор у other
+  SIMPLE_VECTOR_CONSTEXPR ArrayPtr(ArrayPtr &&other) noexcept
+      : alloc_(std::move(other.alloc_)),
+        raw_ptr_(std::exchange(other.raw_ptr_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {
+  }
+
+  SIMPLE_VECTOR_CONSTEXPR ~ArrayPtr() {
+    Deallocate();
   }
 
   // Запрещаем присваивание
   ArrayPtr &operator=(const ArrayPtr &) = delete;
 
+  // Освобождает свою память и забирает память у other.
+  // Аллокатор передаётся, только если этого требует
+  // propagate_on_container_move_assignment, иначе аллокаторы должны быть равны
+  SIMPLE_VECTOR_CONSTEXPR ArrayPtr &operator=(ArrayPtr &&other) noexcept {
+    if (this != &other) {
+      Deallocate();
+      if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+        alloc_ = std::move(other.alloc_);
+      }
+      raw_ptr_ = std::exchange(other.raw_ptr_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
   // Прекращает владением массивом в памяти, возвращает значение адреса массива
   // После вызова метода указатель на массив должен обнулиться
-  [[nodiscard]] Type *Release() noexcept {
+  [[nodiscard]] SIMPLE_VECTOR_CONSTEXPR Type *Release() noexcept {
+    size_ = 0;
     return std::exchange(raw_ptr_, nullptr);
   }
 
+  // Освобождает память, после вызова указатель на массив обнуляется
+  SIMPLE_VECTOR_CONSTEXPR void Reset() noexcept {
+    Deallocate();
+    raw_ptr_ = nullptr;
+    size_ = 0;
+  }
+
+  // Освобождает память и заменяет аллокатор на alloc
+  SIMPLE_VECTOR_CONSTEXPR void ReplaceAllocator(const Allocator &alloc) {
+    Reset();
+    alloc_ = alloc;
+  }
+
+  // Заменяет аллокатор на alloc, не освобождая память. alloc должен быть равен
+  // текущему аллокатору, чтобы им можно было освободить уже выделенную память
+  SIMPLE_VECTOR_CONSTEXPR void AssignEqualAllocator(const Allocator &alloc) {
+    assert(alloc_ == alloc);
+    alloc_ = alloc;
+  }
+
   // Возвращает ссылку на элемент массива с индексом index
-  Type &operator[](size_t index) noexcept {
+  SIMPLE_VECTOR_CONSTEXPR Type &operator[](size_t index) noexcept {
     return raw_ptr_[index];
   }
 
   // Возвращает константную ссылку на элемент массива с индексом index
-  const Type &operator[](size_t index) const noexcept {
+  SIMPLE_VECTOR_CONSTEXPR const Type &operator[](size_t index) const noexcept {
     return raw_ptr_[index];
   }
 
   // Возвращает true, если указатель ненулевой, и false в противном случае
-  explicit operator bool() const {
+  SIMPLE_VECTOR_CONSTEXPR explicit operator bool() const {
     return raw_ptr_ != nullptr;
   }
 
   // Возвращает значение сырого указателя, хранящего адрес начала массива
-  Type *Get() const noexcept {
+  SIMPLE_VECTOR_CONSTEXPR Type *Get() const noexcept {
     return raw_ptr_;
   }
 
-  // Обменивается значениям указателя на массив с объектом other
-  void swap(ArrayPtr &other) noexcept {
+  // Возвращает количество элементов, под которые выделена память
+  SIMPLE_VECTOR_CONSTEXPR size_t GetSize() const noexcept {
+    return size_;
+  }
+
+  // Возвращает аллокатор, через который выделяется память
+  SIMPLE_VECTOR_CONSTEXPR const Allocator &GetAllocator() const noexcept {
+    return alloc_;
+  }
+
+  SIMPLE_VECTOR_CONSTEXPR Allocator &GetAllocator() noexcept {
+    return alloc_;
+  }
+
+  // Обменивается значениям указателя на массив с объектом other.
+  // Аллокаторы обмениваются, только если этого требует propagate_on_container_swap,
+  // иначе они должны быть равны
+  SIMPLE_VECTOR_CONSTEXPR void swap(ArrayPtr &other) noexcept {
+    if constexpr (AllocTraits::propagate_on_container_swap::value) {
+      std::swap(alloc_, other.alloc_);
+    }
     std::swap(raw_ptr_, other.raw_ptr_);
+    std::swap(size_, other.size_);
   }
 
  private:
+  SIMPLE_VECTOR_CONSTEXPR void Deallocate() noexcept {
+    if (raw_ptr_) {
+      AllocTraits::deallocate(alloc_, raw_ptr_, size_);
+    }
+  }
+
+  [[no_unique_address]] Allocator alloc_;
   Type *raw_ptr_ = nullptr;
+  size_t size_ = 0;
 };
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <type_traits>
+
+#include "config.h"
+
+// Режим проверки итераторов SimpleVector для отладочных сборок и канареек.
+// Включается макросом SIMPLE_VECTOR_CHECKED_ITERATORS (опция CMake с тем же именем).
+// Без него итераторы - обычные указатели, и проверки ничего не стоят.
+//
+// В режиме проверки итератор помнит свой вектор и номер поколения его памяти.
+// Вектор увеличивает номер при каждом перевыделении памяти (Reserve, Resize,
+// вставка в заполненный вектор, ShrinkToFit), а также при перемещении и обмене,
+// поэтому обращение через итератор, полученный до этого, обнаруживается.
+// Проверяются также выход итератора и индекса operator[] за границы вектора
+// и сравнение итераторов разных векторов.
+// При нарушении вызывается обработчик (см. SetCheckFailureHandler), по умолчанию
+// печатающий сообщение в stderr и завершающий программу через std::abort.
+// Итераторы разрушенного вектора не проверяются
+
+// Обработчик нарушения проверки. Может бросить исключение; если он вернёт управление,
+// программа будет завершена
+using CheckFailureHandler = void (*)(const char *message);
+
+namespace detail {
+
+inline void DefaultCheckFailureHandler(const char *message) {
+  std::fprintf(stderr, "SimpleVector check failed: %s\n", message);
+}
+
+inline std::atomic<CheckFailureHandler> &GetCheckFailureHandler() noexcept {
+  static std::atomic<CheckFailureHandler> handler{DefaultCheckFailureHandler};
+  return handler;
+}
+
+[[noreturn]] inline void CheckFailed(const char *message) {
+  GetCheckFailureHandler().load()(message);
+  std::abort();
+}
+
+}  // namespace detail
+
+// Устанавливает обработчик нарушений проверки и возвращает прежний.
+// nullptr восстанавливает обработчик по умолчанию
+inline CheckFailureHandler SetCheckFailureHandler(CheckFailureHandler handler) noexcept {
+  return detail::GetCheckFailureHandler().exchange(handler ? handler : detail::DefaultCheckFailureHandler);
+}
+
+#ifdef SIMPLE_VECTOR_CHECKED_ITERATORS
+// Методы с проверками бросают исключение, если его бросает обработчик
+#define SIMPLE_VECTOR_CHECKED_NOEXCEPT
+#else
+#define SIMPLE_VECTOR_CHECKED_NOEXCEPT noexcept
+#endif
+
+namespace detail {
+
+// В режиме проверки итераторов сообщает о нарушении, если condition ложно
+constexpr void Check([[maybe_unused]] bool condition, [[maybe_unused]] const char *message)
+    SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+#ifdef SIMPLE_VECTOR_CHECKED_ITERATORS
+  if (!condition) {
+    CheckFailed(message);
+  }
+#endif
+}
+
+}  // namespace detail
+
+namespace detail {
+
+// Итератор с проверками над элементами Type вектора Owner.
+// Owner предоставляет итератору доступ к array_, size_ и generation_
+template<typename Type, typename Owner>
+class CheckedIterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_cv_t<Type>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = Type *;
+  using reference = Type &;
+
+  constexpr CheckedIterator() noexcept = default;
+
+  constexpr CheckedIterator(const Owner *owner, Type *ptr) noexcept
+      : owner_(owner), ptr_(ptr), generation_(owner->generation_) {
+  }
+
+  // Iterator приводится к ConstIterator
+  template<typename Other, typename = std::enable_if_t<std::is_convertible_v<Other *, Type *>>>
+  constexpr CheckedIterator(const CheckedIterator<Other, Owner> &other) noexcept
+      : owner_(other.owner_), ptr_(other.ptr_), generation_(other.generation_) {
+  }
+
+  // Возвращает указатель на элемент без проверок
+  constexpr Type *Get() const noexcept {
+    return ptr_;
+  }
+
+  constexpr Type &operator*() const {
+    CheckDereferenceable();
+    return *ptr_;
+  }
+
+  constexpr Type *operator->() const {
+    CheckDereferenceable();
+    return ptr_;
+  }
+
+  constexpr Type &operator[](difference_type offset) const {
+    return *(*this + offset);
+  }
+
+  constexpr CheckedIterator &operator++() {
+    return *this += 1;
+  }
+
+  constexpr CheckedIterator operator++(int) {
+    CheckedIterator old = *this;
+    ++*this;
+    return old;
+  }
+
+  constexpr CheckedIterator &operator--() {
+    return *this -= 1;
+  }
+
+  constexpr CheckedIterator operator--(int) {
+    CheckedIterator old = *this;
+    --*this;
+    return old;
+  }
+
+  constexpr CheckedIterator &operator+=(difference_type offset) {
+    CheckValid();
+    // Итератор, созданный по умолчанию, можно сдвинуть только на 0
+    if (!owner_) {
+      if (offset != 0) {
+        CheckFailed("iterator is not attached to a vector");
+      }
+      return *this;
+    }
+    const difference_type index = ptr_ - Begin();
+    if (offset < -index || offset > static_cast<difference_type>(owner_->size_) - index) {
+      CheckFailed("iterator moved out of range");
+    }
+    ptr_ += offset;
+    return *this;
+  }
+
+  constexpr CheckedIterator &operator-=(difference_type offset) {
+    return *this += -offset;
+  }
+
+  friend constexpr CheckedIterator operator+(CheckedIterator it, difference_type offset) {
+    return it += offset;
+  }
+
+  friend constexpr CheckedIterator operator+(difference_type offset, CheckedIterator it) {
+    return it += offset;
+  }
+
+  friend constexpr CheckedIterator operator-(CheckedIterator it, difference_type offset) {
+    return it -= offset;
+  }
+
+  // Проверяет, что итератор действителен и принадлежит вектору owner
+  constexpr void CheckOwner(const Owner *owner) const {
+    if (owner_ != owner) {
+      CheckFailed("iterator belongs to another vector");
+    }
+    CheckValid();
+  }
+
+  // Проверяет, что итераторы действительны и принадлежат одному вектору
+  template<typename Other>
+  constexpr void CheckComparable(const CheckedIterator<Other, Owner> &other) const {
+    if (owner_ != other.owner_) {
+      CheckFailed("iterators of different vectors are compared");
+    }
+    CheckValid();
+    other.CheckValid();
+  }
+
+ private:
+  template<typename, typename>
+  friend class CheckedIterator;
+
+  constexpr const Type *Begin() const noexcept {
+    return owner_->array_.Get();
+  }
+
+  constexpr void CheckValid() const {
+    if (!owner_) {
+      if (ptr_) {
+        CheckFailed("iterator is not attached to a vector");
+      }
+      return;
+    }
+    if (generation_ != owner_->generation_) {
+      CheckFailed("iterator is invalidated by reallocation");
+    }
+    if (ptr_ < Begin() || ptr_ > Begin() + owner_->size_) {
+      CheckFailed("iterator is out of range");
+    }
+  }
+
+  constexpr void CheckDereferenceable() const {
+    CheckValid();
+    if (!owner_ || ptr_ == Begin() + owner_->size_) {
+      CheckFailed("iterator is not dereferenceable");
+    }
+  }
+
+  const Owner *owner_ = nullptr;
+  Type *ptr_ = nullptr;
+  size_t generation_ = 0;
+};
+
+template<typename Type, typename Other, typename Owner>
+constexpr std::ptrdiff_t operator-(const CheckedIterator<Type, Owner> &lhs, const CheckedIterator<Other, Owner> &rhs) {
+  lhs.CheckComparable(rhs);
+  return lhs.Get() - rhs.Get();
+}
+
+template<typename Type, typename Other, typename Owner>
+constexpr bool operator==(const CheckedIterator<Type, Owner> &lhs, const CheckedIterator<Other, Owner> &rhs) {
+  lhs.CheckComparable(rhs);
+  return lhs.Get() == rhs.Get();
+}
+
+template<typename Type, typename Other, typename Owner>
+constexpr bool operator!=(const CheckedIterator<Type, Owner> &lhs, const CheckedIterator<Other, Owner> &rhs) {
+  return !(lhs == rhs);
+}
+
+template<typename Type, typename Other, typename Owner>
+constexpr bool operator<(const CheckedIterator<Type, Owner> &lhs, const CheckedIterator<Other, Owner> &rhs) {
+  lhs.CheckComparable(rhs);
+  return lhs.Get() < rhs.Get();
+}
+
+template<typename Type, typename Other, typename Owner>
+constexpr bool operator<=(const CheckedIterator<Type, Owner> &lhs, const CheckedIterator<Other, Owner> &rhs) {
+  return !(rhs < lhs);
+}
+
+template<typename Type, typename Other, typename Owner>
+constexpr bool operator>(const CheckedIterator<Type, Owner> &lhs, const CheckedIterator<Other, Owner> &rhs) {
+  return rhs < lhs;
+}
+
+template<typename Type, typename Other, typename Owner>
+constexpr bool operator>=(const CheckedIterator<Type, Owner> &lhs, const CheckedIterator<Other, Owner> &rhs) {
+  return !(lhs < rhs);
+}
+
+// Адрес элемента, на который указывает итератор непрерывного контейнера
+template<typename Type>
+constexpr Type *ToAddress(Type *ptr) noexcept {
+  return ptr;
+}
+
+template<typename Type, typename Owner>
+constexpr Type *ToAddress(const CheckedIterator<Type, Owner> &it) noexcept {
+  return it.Get();
+}
+
+}  // namespace detail
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "memory_utils.h"
+#include "simple_vector.h"
+
+// Вектор для одновременного добавления элементов из нескольких потоков без блокировок.
+// PushBack занимает номер ячейки одним fetch_add и создаёт элемент на своём месте.
+// Элементы хранятся в сегментах, каждый следующий вдвое больше предыдущего:
+// сегменты не перевыделяются, поэтому элементы никогда не перемещаются, а ссылки
+// на них остаются действительными, пока вектор не очищен.
+// Читатели не блокируются: IsReady и TryGet сообщают, создан ли уже элемент с данным номером.
+// Когда добавление закончено, Freeze() переносит элементы в непрерывный SimpleVector.
+// Аллокатор должен допускать вызовы из нескольких потоков, как std::allocator
+// и std::pmr::polymorphic_allocator над синхронизированным ресурсом
+template<typename Type, typename Allocator = std::allocator<Type>>
+class ConcurrentSimpleVector {
+  using AllocTraits = std::allocator_traits<Allocator>;
+
+  // Состояние ячейки. Хранится в байте за элементами сегмента
+  enum SlotState : unsigned char {
+    kEmpty,
+    kReady,
+    // Создание элемента бросило исключение; Freeze пропускает такую ячейку
+    kFailed,
+  };
+
+  using StateType = std::atomic<unsigned char>;
+  static_assert(sizeof(StateType) == 1 && alignof(StateType) == 1);
+
+ public:
+  using AllocatorType = Allocator;
+  using SimpleVectorType = SimpleVector<Type, Allocator>;
+
+  // Размер первого сегмента - 2^kFirstSegmentBits элементов
+  static constexpr size_t kFirstSegmentBits = 5;
+  static constexpr size_t kMaxSegments = sizeof(size_t) * 8 - kFirstSegmentBits;
+
+  ConcurrentSimpleVector() noexcept(noexcept(Allocator())) = default;
+
+  explicit ConcurrentSimpleVector(const Allocator &alloc) noexcept : alloc_(alloc) {
+  }
+
+  // Сразу выделяет сегменты под capacity элементов
+  explicit ConcurrentSimpleVector(size_t capacity, const Allocator &alloc = Allocator()) : alloc_(alloc) {
+    Reserve(capacity);
+  }
+
+  ConcurrentSimpleVector(const ConcurrentSimpleVector &) = delete;
+  ConcurrentSimpleVector &operator=(const ConcurrentSimpleVector &) = delete;
+
+  ~ConcurrentSimpleVector() {
+    Clear();
+  }
+
+  // Добавляет элемент и возвращает его номер. Можно вызывать из нескольких потоков.
+  // Если создание элемента бросает исключение, ячейка остаётся пустой
+  size_t PushBack(const Type &item) {
+    return EmplaceBack(item);
+  }
+
+  size_t PushBack(Type &&item) {
+    return EmplaceBack(std::move(item));
+  }
+
+  // Создаёт элемент из аргументов args в очередной ячейке и возвращает её номер
+  template<typename... Args>
+  size_t EmplaceBack(Args &&... args) {
+    const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+    const Location location = Locate(index);
+    Type *const data = GetOrAllocateSegment(location.segment);
+    try {
+      AllocTraits::construct(alloc_, data + location.offset, std::forward<Args>(args)...);
+    } catch (...) {
+      GetState(data, location.segment, location.offset).store(kFailed, std::memory_order_release);
+      throw;
+    }
+    GetState(data, location.segment, location.offset).store(kReady, std::memory_order_release);
+    return index;
+  }
+
+  // Число занятых ячеек, включая те, элементы в которых ещё создаются
+  size_t GetSize() const noexcept {
+    return size_.load(std::memory_order_acquire);
+  }
+
+  bool IsEmpty() const noexcept {
+    return GetSize() == 0;
+  }
+
+  // Число элементов, под которые выделены сегменты
+  size_t GetCapacity() const noexcept {
+    size_t capacity = 0;
+    for (size_t segment = 0; segment < kMaxSegments; ++segment) {
+      if (segments_[segment].load(std::memory_order_acquire)) {
+        capacity += SegmentSize(segment);
+      }
+    }
+    return capacity;
+  }
+
+  // Создан ли уже элемент с номером index. Не блокирует добавляющие потоки
+  bool IsReady(size_t index) const noexcept {
+    return TryGet(index) != nullptr;
+  }
+
+  // Возвращает указатель на элемент с номером index или nullptr, если он ещё не создан
+  const Type *TryGet(size_t index) const noexcept {
+    if (index >= GetSize()) {
+      return nullptr;
+    }
+    const Location location = Locate(index);
+    Type *const data = segments_[location.segment].load(std::memory_order_acquire);
+    if (!data || GetState(data, location.segment, location.offset).load(std::memory_order_acquire) != kReady) {
+      return nullptr;
+    }
+    return data + location.offset;
+  }
+
+  Type *TryGet(size_t index) noexcept {
+    return const_cast<Type *>(std::as_const(*this).TryGet(index));
+  }
+
+  // Возвращает ссылку на созданный элемент с номером index
+  // (например, номер, который вернул PushBack в этом же потоке)
+  Type &operator[](size_t index) noexcept {
+    assert(IsReady(index));
+    const Location location = Locate(index);
+    return segments_[location.segment].load(std::memory_order_acquire)[location.offset];
+  }
+
+  const Type &operator[](size_t index) const noexcept {
+    assert(IsReady(index));
+    const Location location = Locate(index);
+    return segments_[location.segment].load(std::memory_order_acquire)[location.offset];
+  }
+
+  // Возвращает ссылку на элемент с номером index.
+  // Выбрасывает исключение std::out_of_range, если элемент ещё не создан
+  const Type &At(size_t index) const {
+    const Type *item = TryGet(index);
+    if (!item) {
+      throw std::out_of_range("Index is out of range");
+    }
+    return *item;
+  }
+
+  // Выделяет сегменты так, чтобы в них поместилось не меньше capacity элементов.
+  // Можно вызывать одновременно с PushBack
+  void Reserve(size_t capacity) {
+    for (size_t segment = 0; segment < kMaxSegments && SegmentStart(segment) < capacity; ++segment) {
+      GetOrAllocateSegment(segment);
+    }
+  }
+
+  // Переносит созданные элементы в порядке их номеров в непрерывный SimpleVector
+  // и очищает этот вектор. Пустые ячейки пропускаются.
+  // Нельзя вызывать одновременно с другими методами
+  SimpleVectorType Freeze() {
+    const size_t size = GetSize();
+    SimpleVectorType result(alloc_);
+    result.Reserve(size);
+    for (size_t segment = 0; segment < kMaxSegments && SegmentStart(segment) < size; ++segment) {
+      Type *const data = segments_[segment].load(std::memory_order_acquire);
+      if (!data) {
+        continue;
+      }
+      const size_t count = std::min(SegmentSize(segment), size - SegmentStart(segment));
+      // Переносит подряд идущие созданные элементы одним вызовом
+      size_t first = 0;
+      while (first < count) {
+        while (first < count && GetState(data, segment, first).load(std::memory_order_relaxed) != kReady) {
+          ++first;
+        }
+        size_t last = first;
+        while (last < count && GetState(data, segment, last).load(std::memory_order_relaxed) == kReady) {
+          ++last;
+        }
+        if constexpr (std::is_trivially_copyable_v<Type>) {
+          result.Append(static_cast<const Type *>(data + first), static_cast<const Type *>(data + last));
+        } else {
+          result.Append(std::make_move_iterator(data + first), std::make_move_iterator(data + last));
+        }
+        first = last;
+      }
+    }
+    Clear();
+    return result;
+  }
+
+  // Разрушает все элементы и освобождает сегменты.
+  // Нельзя вызывать одновременно с другими методами
+  void Clear() noexcept {
+    const size_t size = size_.exchange(0, std::memory_order_relaxed);
+    for (size_t segment = 0; segment < kMaxSegments; ++segment) {
+      Type *const data = segments_[segment].exchange(nullptr, std::memory_order_acquire);
+      allocating_[segment].store(false, std::memory_order_relaxed);
+      if (!data) {
+        continue;
+      }
+      const size_t count = SegmentStart(segment) < size
+          ? std::min(SegmentSize(segment), size - SegmentStart(segment)) : 0;
+      for (size_t offset = 0; offset < count; ++offset) {
+        if (GetState(data, segment, offset).load(std::memory_order_relaxed) == kReady) {
+          AllocTraits::destroy(alloc_, data + offset);
+        }
+      }
+      AllocTraits::deallocate(alloc_, data, AllocationSize(segment));
+    }
+  }
+
+  Allocator GetAllocator() const noexcept {
+    return alloc_;
+  }
+
+ private:
+  // Сегмент и смещение в нём для номера ячейки
+  struct Location {
+    size_t segment;
+    size_t offset;
+  };
+
+  static constexpr size_t SegmentSize(size_t segment) noexcept {
+    return size_t{1} << (segment + kFirstSegmentBits);
+  }
+
+  // Номер первой ячейки сегмента
+  static constexpr size_t SegmentStart(size_t segment) noexcept {
+    return SegmentSize(segment) - SegmentSize(0);
+  }
+
+  static Location Locate(size_t index) noexcept {
+    const size_t shifted = index + SegmentSize(0);
+    const size_t high_bit = sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(shifted);
+    return {high_bit - kFirstSegmentBits, shifted - (size_t{1} << high_bit)};
+  }
+
+  // Число элементов Type, которые выделяются под сегмент: сами элементы
+  // и байты состояний ячеек за ними
+  static constexpr size_t AllocationSize(size_t segment) noexcept {
+    return SegmentSize(segment) + (SegmentSize(segment) + sizeof(Type) - 1) / sizeof(Type);
+  }
+
+  static StateType &GetState(Type *data, size_t segment, size_t offset) noexcept {
+    return reinterpret_cast<StateType *>(data + SegmentSize(segment))[offset];
+  }
+
+  // Возвращает сегмент, выделяя его, если его ещё нет. Сегмент выделяет ровно один поток,
+  // занявший флаг allocating_, а остальные ждут, пока он опубликует сегмент,
+  // поэтому на границе сегмента память и состояния ячеек не создаются впустую
+  Type *GetOrAllocateSegment(size_t segment) {
+    while (true) {
+      Type *const data = segments_[segment].load(std::memory_order_acquire);
+      if (data) {
+        return data;
+      }
+      // Флаг остаётся занятым после публикации: опоздавший поток увидит сегмент при следующей проверке
+      if (!allocating_[segment].exchange(true, std::memory_order_acquire)) {
+        return AllocateSegment(segment);
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  // Выделяет и публикует сегмент. Вызывается потоком, занявшим флаг allocating_;
+  // если выделение бросает исключение, флаг освобождается и сегмент может выделить другой поток
+  Type *AllocateSegment(size_t segment) {
+    Type *allocated;
+    try {
+      allocated = AllocTraits::allocate(alloc_, AllocationSize(segment));
+    } catch (...) {
+      allocating_[segment].store(false, std::memory_order_release);
+      throw;
+    }
+    auto *states = reinterpret_cast<unsigned char *>(allocated + SegmentSize(segment));
+    for (size_t offset = 0; offset < SegmentSize(segment); ++offset) {
+      new(states + offset) StateType(kEmpty);
+    }
+    segments_[segment].store(allocated, std::memory_order_release);
+    return allocated;
+  }
+
+  [[no_unique_address]] Allocator alloc_;
+  std::atomic<size_t> size_{0};
+  std::array<std::atomic<Type *>, kMaxSegments> segments_{};
+  // Занят потоком, который выделяет сегмент или уже выделил его
+  std::array<std::atomic<bool>, kMaxSegments> allocating_{};
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+// SIMPLE_VECTOR_CONSTEXPR помечает функции, которые можно вычислять во время компиляции,
+// если стандарт разрешает выделять память в constexpr-функциях (C++20).
+// В C++17 макрос пуст, и те же функции работают только во время выполнения
+#if defined(__cpp_constexpr_dynamic_alloc) && defined(__cpp_lib_constexpr_dynamic_alloc)
+#define SIMPLE_VECTOR_CONSTEXPR constexpr
+#define SIMPLE_VECTOR_HAS_CONSTEXPR 1
+#else
+#define SIMPLE_VECTOR_CONSTEXPR
+#endif
+
+namespace detail {
+
+// Вычисляется ли вызов во время компиляции. Там недоступны memcpy, memmove, memcmp
+// и SIMD-инструкции, и вместо них используются поэлементные алгоритмы
+constexpr bool IsConstantEvaluated() noexcept {
+#if defined(__cpp_lib_is_constant_evaluated)
+  return std::is_constant_evaluated();
+#else
+  return false;
+#endif
+}
+
+}  // namespace detail
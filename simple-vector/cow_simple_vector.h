@@ -0,0 +1,396 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "simd_compare.h"
+#include "simple_vector.h"
+
+// Вектор с копированием при записи (copy-on-write).
+// Копии разделяют один буфер - SimpleVector с атомарным счётчиком ссылок,
+// поэтому копирование стоит O(1) и подходит для раздачи снимков многим читателям.
+// Изменяющие методы копируют буфер, только если он разделён с другими векторами.
+// Разные векторы с общим буфером можно читать и изменять из разных потоков;
+// один вектор, как и SimpleVector, из нескольких потоков можно только читать.
+// Итераторы только константные, чтобы обход не копировал разделённый буфер.
+// Ссылки, полученные изменяющими методами, действительны до следующего копирования вектора
+template<typename Type, typename Allocator = std::allocator<Type>>
+class CowSimpleVector {
+  // Буфер и число векторов, которые на него ссылаются
+  struct SharedBuffer;
+  using BufferAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<SharedBuffer>;
+  using BufferTraits = std::allocator_traits<BufferAllocator>;
+
+ public:
+  using VectorType = SimpleVector<Type, Allocator>;
+  using ConstIterator = typename VectorType::ConstIterator;
+  using AllocatorType = Allocator;
+
+  CowSimpleVector() noexcept(noexcept(Allocator())) = default;
+
+  explicit CowSimpleVector(const Allocator &alloc) noexcept : alloc_(alloc) {
+  }
+
+  // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+  explicit CowSimpleVector(size_t size, const Allocator &alloc = Allocator())
+      : alloc_(alloc), data_(CreateBuffer(alloc, size, alloc)) {
+  }
+
+  // Создаёт вектор из size элементов, инициализированных значением value
+  CowSimpleVector(size_t size, const Type &value, const Allocator &alloc = Allocator())
+      : alloc_(alloc), data_(CreateBuffer(alloc, size, value, alloc)) {
+  }
+
+  // Создаёт вектор из std::initializer_list
+  CowSimpleVector(std::initializer_list<Type> init, const Allocator &alloc = Allocator())
+      : alloc_(alloc), data_(CreateBuffer(alloc, init, alloc)) {
+  }
+
+  // Забирает элементы vector без копирования
+  explicit CowSimpleVector(VectorType &&vector)
+      : alloc_(vector.GetAllocator()), data_(CreateBuffer(vector.GetAllocator(), std::move(vector))) {
+  }
+
+  // Копия разделяет буфер с other
+  CowSimpleVector(const CowSimpleVector &other) noexcept : alloc_(other.alloc_), data_(other.data_) {
+    if (data_) {
+      // Новая ссылка появляется только из существующей, поэтому упорядочивать нечего
+      data_->references.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  CowSimpleVector(CowSimpleVector &&other) noexcept
+      : alloc_(std::move(other.alloc_)), data_(std::exchange(other.data_, nullptr)) {
+  }
+
+  CowSimpleVector &operator=(const CowSimpleVector &rhs) noexcept {
+    CowSimpleVector copy(rhs);
+    swap(copy);
+    return *this;
+  }
+
+  CowSimpleVector &operator=(CowSimpleVector &&rhs) noexcept {
+    CowSimpleVector moved(std::move(rhs));
+    swap(moved);
+    return *this;
+  }
+
+  ~CowSimpleVector() {
+    ReleaseBuffer();
+  }
+
+  // Возвращает копию аллокатора вектора
+  Allocator GetAllocator() const noexcept {
+    return alloc_;
+  }
+
+  // Возвращает буфер вектора для передачи туда, где нужен SimpleVector.
+  // Ссылка действительна до изменения вектора
+  const VectorType &GetVector() const noexcept {
+    assert(data_);
+    return data_->vector;
+  }
+
+  // Сообщает, разделён ли буфер с другими векторами
+  bool IsShared() const noexcept {
+    return data_ && data_->references.load(std::memory_order_acquire) > 1;
+  }
+
+  size_t GetSize() const noexcept {
+    return data_ ? data_->vector.GetSize() : 0;
+  }
+
+  size_t GetCapacity() const noexcept {
+    return data_ ? data_->vector.GetCapacity() : 0;
+  }
+
+  bool IsEmpty() const noexcept {
+    return GetSize() == 0;
+  }
+
+  // Возвращает константную ссылку на элемент с индексом index
+  const Type &operator[](size_t index) const noexcept {
+    assert(index < GetSize());
+    return data_->vector[index];
+  }
+
+  // Возвращает ссылку на элемент с индексом index, копируя разделённый буфер
+  Type &operator[](size_t index) {
+    assert(index < GetSize());
+    MakeUnique(GetSize(), GetSize());
+    return data_->vector[index];
+  }
+
+  // Выбрасывает исключение std::out_of_range, если index >= size
+  const Type &At(size_t index) const {
+    if (index >= GetSize()) {
+      throw std::out_of_range("out_of_range");
+    }
+    return data_->vector[index];
+  }
+
+  // Выбрасывает исключение std::out_of_range, если index >= size.
+  // Копирует разделённый буфер
+  Type &At(size_t index) {
+    if (index >= GetSize()) {
+      throw std::out_of_range("out_of_range");
+    }
+    return (*this)[index];
+  }
+
+  const Type *Data() const noexcept {
+    return data_ ? data_->vector.Data() : nullptr;
+  }
+
+  ConstIterator begin() const noexcept {
+    return data_ ? data_->vector.cbegin() : ConstIterator();
+  }
+
+  ConstIterator end() const noexcept {
+    return data_ ? data_->vector.cend() : ConstIterator();
+  }
+
+  ConstIterator cbegin() const noexcept {
+    return begin();
+  }
+
+  ConstIterator cend() const noexcept {
+    return end();
+  }
+
+  // Разделённый буфер не копируется: вектор просто перестаёт на него ссылаться
+  void Clear() noexcept {
+    if (IsShared()) {
+      ReleaseBuffer();
+    } else if (data_) {
+      data_->vector.Clear();
+    }
+  }
+
+  // Изменяет размер массива. Из разделённого буфера копируются только остающиеся элементы
+  void Resize(size_t new_size) {
+    MakeUnique(new_size, std::min(new_size, GetSize()));
+    data_->vector.Resize(new_size);
+  }
+
+  void Resize(size_t new_size, const Type &value) {
+    // value может лежать в разделённом буфере, который освобождается при копировании
+    const auto old_data = MakeUnique(new_size, std::min(new_size, GetSize()));
+    data_->vector.Resize(new_size, value);
+  }
+
+  // Резервирует память под new_capacity элементов. Если вместимости хватает,
+  // ничего не делает, иначе разделённый буфер копируется сразу с новой вместимостью
+  void Reserve(size_t new_capacity) {
+    if (new_capacity <= GetCapacity()) {
+      return;
+    }
+    if (IsOwned()) {
+      data_->vector.Reserve(new_capacity);
+    } else {
+      CopyBuffer(new_capacity, GetSize());
+    }
+  }
+
+  void PushBack(const Type &item) {
+    EmplaceBack(item);
+  }
+
+  void PushBack(Type &&item) {
+    EmplaceBack(std::move(item));
+  }
+
+  // Создаёт элемент в конце вектора. Разделённый буфер копируется в память,
+  // в которой уже есть место для нового элемента
+  template<typename... Args>
+  Type &EmplaceBack(Args &&... args) {
+    const auto old_data = MakeUnique(GetSize() + 1, GetSize());
+    return data_->vector.EmplaceBack(std::forward<Args>(args)...);
+  }
+
+  // Удаляет последний элемент вектора. Вектор не должен быть пустым
+  void PopBack() {
+    assert(!IsEmpty());
+    if (IsShared()) {
+      MakeUnique(GetSize() - 1, GetSize() - 1);
+    } else {
+      data_->vector.PopBack();
+    }
+  }
+
+  // Вставляет значение value в позицию pos. Возвращает итератор на вставленное значение
+  ConstIterator Insert(ConstIterator pos, const Type &value) {
+    return Emplace(pos, value);
+  }
+
+  ConstIterator Insert(ConstIterator pos, Type &&value) {
+    return Emplace(pos, std::move(value));
+  }
+
+  template<typename... Args>
+  ConstIterator Emplace(ConstIterator pos, Args &&... args) {
+    const size_t index = pos - begin();
+    const auto old_data = MakeUnique(GetSize() + 1, GetSize());
+    return data_->vector.Emplace(data_->vector.cbegin() + index, std::forward<Args>(args)...);
+  }
+
+  // Удаляет элемент вектора в указанной позиции
+  ConstIterator Erase(ConstIterator pos) {
+    assert(pos != end());
+    return Erase(pos, pos + 1);
+  }
+
+  // Удаляет элементы [first, last). Из разделённого буфера копируются
+  // только остающиеся элементы
+  ConstIterator Erase(ConstIterator first, ConstIterator last) {
+    const size_t index = first - begin();
+    const size_t count = last - first;
+    if (!IsShared()) {
+      return data_ ? data_->vector.Erase(first, last) : begin();
+    }
+    const VectorType &source = data_->vector;
+    SharedBuffer *copy = CreateCopy(GetSize() - count, [&](VectorType &vector) {
+      vector.Append(source.Data(), source.Data() + index);
+      vector.Append(source.Data() + index + count, source.Data() + source.GetSize());
+    });
+    ReleaseBuffer();
+    data_ = copy;
+    return begin() + index;
+  }
+
+  void swap(CowSimpleVector &other) noexcept {
+    std::swap(alloc_, other.alloc_);
+    std::swap(data_, other.data_);
+  }
+
+ private:
+  struct SharedBuffer {
+    template<typename... Args>
+    explicit SharedBuffer(Args &&... args) : vector(std::forward<Args>(args)...) {
+    }
+
+    VectorType vector;
+    std::atomic<size_t> references{1};
+  };
+
+  // Создаёт буфер с вектором, построенным из args, в памяти аллокатора alloc.
+  // Аллокатор передаётся явно: конструкторы вызывают метод, пока alloc_ ещё не создан
+  template<typename... Args>
+  static SharedBuffer *CreateBuffer(const Allocator &alloc, Args &&... args) {
+    BufferAllocator buffer_alloc(alloc);
+    SharedBuffer *buffer = BufferTraits::allocate(buffer_alloc, 1);
+    try {
+      BufferTraits::construct(buffer_alloc, buffer, std::forward<Args>(args)...);
+    } catch (...) {
+      BufferTraits::deallocate(buffer_alloc, buffer, 1);
+      throw;
+    }
+    return buffer;
+  }
+
+  // Создаёт буфер вместимостью capacity и заполняет его вектор вызовом fill(vector)
+  template<typename FillFn>
+  SharedBuffer *CreateCopy(size_t capacity, FillFn fill) {
+    SharedBuffer *buffer = CreateBuffer(alloc_, ::Reserve(capacity), alloc_);
+    try {
+      fill(buffer->vector);
+    } catch (...) {
+      DestroyBuffer(buffer);
+      throw;
+    }
+    return buffer;
+  }
+
+  void DestroyBuffer(SharedBuffer *buffer) noexcept {
+    BufferAllocator alloc(alloc_);
+    BufferTraits::destroy(alloc, buffer);
+    BufferTraits::deallocate(alloc, buffer, 1);
+  }
+
+  // Перестаёт ссылаться на буфер; последний вектор, ссылавшийся на него, его разрушает.
+  // acq_rel упорядочивает изменения буфера этим вектором до разрушения или изменения
+  // буфера вектором, который останется его единственным владельцем
+  void ReleaseBuffer() noexcept {
+    if (data_ && data_->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      DestroyBuffer(data_);
+    }
+    data_ = nullptr;
+  }
+
+  // Сообщает, что буфер существует и других ссылок на него нет. Другие векторы могут
+  // отпускать буфер из своих потоков; acquire делает их чтения буфера завершёнными до изменений
+  bool IsOwned() const noexcept {
+    return data_ && data_->references.load(std::memory_order_acquire) == 1;
+  }
+
+  // Заменяет буфер собственным буфером вместимостью capacity с копиями первых copy_count элементов.
+  // Возвращает вектор с прежним буфером, чтобы аргументы изменяющего метода,
+  // ссылающиеся на его элементы, оставались действительными до конца метода
+  CowSimpleVector CopyBuffer(size_t capacity, size_t copy_count) {
+    SharedBuffer *copy = CreateCopy(capacity, [&](VectorType &vector) {
+      if (data_) {
+        vector.Assign(data_->vector.Data(), data_->vector.Data() + copy_count);
+      }
+    });
+    CowSimpleVector old_data(alloc_);
+    old_data.data_ = std::exchange(data_, copy);
+    return old_data;
+  }
+
+  // Делает буфер собственным: если он разделён с другими векторами или ещё не создан,
+  // создаёт новый на new_size элементов и копирует в него первые copy_count элементов.
+  // Вместимость выбирается так, чтобы вставка, ради которой копируется буфер,
+  // не выделяла память ещё раз. Возвращает прежний буфер (см. CopyBuffer)
+  CowSimpleVector MakeUnique(size_t new_size, size_t copy_count) {
+    if (IsOwned()) {
+      return CowSimpleVector(alloc_);
+    }
+    return CopyBuffer(data_ ? data_->vector.GetGrowthCapacity(new_size) : new_size, copy_count);
+  }
+
+  [[no_unique_address]] Allocator alloc_;
+  SharedBuffer *data_ = nullptr;
+};
+
+template<typename Type, typename Allocator>
+bool operator==(const CowSimpleVector<Type, Allocator> &lhs, const CowSimpleVector<Type, Allocator> &rhs) {
+  // Векторы с общим буфером равны без сравнения элементов
+  return lhs.GetSize() == rhs.GetSize()
+      && (lhs.Data() == rhs.Data() || detail::RangesEqual(lhs.Data(), rhs.Data(), lhs.GetSize()));
+}
+
+template<typename Type, typename Allocator>
+bool operator!=(const CowSimpleVector<Type, Allocator> &lhs, const CowSimpleVector<Type, Allocator> &rhs) {
+  return !(lhs == rhs);
+}
+
+template<typename Type, typename Allocator>
+bool operator<(const CowSimpleVector<Type, Allocator> &lhs, const CowSimpleVector<Type, Allocator> &rhs) {
+  return detail::LexicographicalLess(lhs.Data(), lhs.GetSize(), rhs.Data(), rhs.GetSize());
+}
+
+template<typename Type, typename Allocator>
+bool operator<=(const CowSimpleVector<Type, Allocator> &lhs, const CowSimpleVector<Type, Allocator> &rhs) {
+  return !(rhs < lhs);
+}
+
+template<typename Type, typename Allocator>
+bool operator>(const CowSimpleVector<Type, Allocator> &lhs, const CowSimpleVector<Type, Allocator> &rhs) {
+  return rhs < lhs;
+}
+
+template<typename Type, typename Allocator>
+bool operator>=(const CowSimpleVector<Type, Allocator> &lhs, const CowSimpleVector<Type, Allocator> &rhs) {
+  return !(lhs < rhs);
+}
+
+template<typename Type, typename Allocator>
+void swap(CowSimpleVector<Type, Allocator> &lhs, CowSimpleVector<Type, Allocator> &rhs) noexcept {
+  lhs.swap(rhs);
+}
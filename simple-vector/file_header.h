@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+// Заголовок файла с элементами вектора. Элементы лежат сразу за заголовком
+// в порядке байтов той машины, которая их записала.
+// Заголовок занимает 64 байта, поэтому данные в отображённом в память файле
+// выровнены по кэш-линии
+namespace detail {
+
+inline constexpr char kFileMagic[8] = {'S', 'M', 'P', 'L', 'V', 'E', 'C', '\0'};
+inline constexpr uint32_t kFileVersion = 1;
+// Записывается в родном порядке байтов: на машине с другим порядком читается как 0x0201
+inline constexpr uint16_t kEndiannessTag = 0x0102;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint16_t endianness;
+  uint16_t header_size;
+  uint64_t element_size;
+  uint64_t size;
+  uint8_t reserved[32];
+};
+
+static_assert(sizeof(FileHeader) == 64);
+
+inline FileHeader MakeFileHeader(size_t element_size, size_t size) noexcept {
+  FileHeader header{};
+  std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+  header.version = kFileVersion;
+  header.endianness = kEndiannessTag;
+  header.header_size = sizeof(FileHeader);
+  header.element_size = element_size;
+  header.size = size;
+  return header;
+}
+
+// Проверяет, что данные за заголовком можно читать как элементы размера element_size
+inline void ValidateFileHeader(const FileHeader &header, size_t element_size) {
+  if (std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0) {
+    throw std::runtime_error("not a SimpleVector file");
+  }
+  if (header.endianness != kEndiannessTag) {
+    throw std::runtime_error("SimpleVector file has a different byte order");
+  }
+  if (header.version != kFileVersion || header.header_size != sizeof(FileHeader)) {
+    throw std::runtime_error("unsupported SimpleVector file version " + std::to_string(header.version));
+  }
+  if (header.element_size != element_size) {
+    throw std::runtime_error("SimpleVector file element size " + std::to_string(header.element_size)
+                                 + " does not match " + std::to_string(element_size));
+  }
+}
+
+}  // namespace detail
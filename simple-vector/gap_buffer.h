@@ -0,0 +1,509 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "array_ptr.h"
+#include "checked_iterator.h"
+#include "growth_policy.h"
+#include "index_iterator.h"
+#include "memory_utils.h"
+#include "simple_span.h"
+
+// Буфер с разрывом (gap buffer) для многократных вставок и удалений около курсора,
+// как в текстовом редакторе. Элементы лежат в одном блоке памяти двумя частями:
+// [0, gap_begin) и [gap_end, capacity), а между ними - неинициализированный разрыв.
+// Вставка в позицию разрыва создаёт элемент в его начале, удаление в этой позиции
+// разрушает элемент за его концом, поэтому обе операции - O(1).
+// Вставка или удаление в другой позиции сначала переносит разрыв туда, перемещая
+// элементы между старой и новой позицией, так что серия правок на расстоянии d
+// друг от друга стоит O(d), а не O(size) на каждую правку, как у SimpleVector.
+// Когда разрыв заканчивается, память перевыделяется по GrowthPolicy.
+// Compact() переносит разрыв в конец, после чего элементы лежат подряд.
+// Итераторы хранят номер элемента и после правок указывают на элемент с тем же номером
+template<typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class GapBuffer {
+  using AllocTraits = std::allocator_traits<Allocator>;
+
+ public:
+  using ValueType = Type;
+  using Iterator = detail::IndexIterator<GapBuffer, Type &>;
+  using ConstIterator = detail::IndexIterator<const GapBuffer, const Type &>;
+  using AllocatorType = Allocator;
+  using GrowthPolicyType = GrowthPolicy;
+
+  GapBuffer() noexcept(noexcept(Allocator())) = default;
+
+  explicit GapBuffer(const Allocator &alloc) noexcept : array_(alloc) {
+  }
+
+  // Создаёт буфер из size элементов, инициализированных значением по умолчанию
+  explicit GapBuffer(size_t size, const Allocator &alloc = Allocator())
+      : array_(size, alloc), gap_begin_(size), gap_end_(size) {
+    detail::UninitializedValueConstruct(array_.GetAllocator(), array_.Get(), array_.Get() + size);
+  }
+
+  // Создаёт буфер из size элементов, инициализированных значением value
+  GapBuffer(size_t size, const Type &value, const Allocator &alloc = Allocator())
+      : array_(size, alloc), gap_begin_(size), gap_end_(size) {
+    detail::UninitializedFill(array_.GetAllocator(), array_.Get(), array_.Get() + size, value);
+  }
+
+  GapBuffer(std::initializer_list<Type> init, const Allocator &alloc = Allocator())
+      : array_(init.size(), alloc), gap_begin_(init.size()), gap_end_(init.size()) {
+    detail::UninitializedCopy(array_.GetAllocator(), init.begin(), init.end(), array_.Get());
+  }
+
+  GapBuffer(const GapBuffer &other)
+      : GapBuffer(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+  }
+
+  // Создаёт копию other без разрыва, память для которой выделяется аллокатором alloc
+  GapBuffer(const GapBuffer &other, const Allocator &alloc)
+      : array_(other.GetSize(), alloc), gap_begin_(other.GetSize()), gap_end_(other.GetSize()) {
+    auto &array_alloc = array_.GetAllocator();
+    const Type *source = other.array_.Get();
+    detail::ConstructionGuard prefix(array_alloc, array_.Get(),
+                                     detail::UninitializedCopy(array_alloc, source, source + other.gap_begin_,
+                                                               array_.Get()));
+    detail::UninitializedCopy(array_alloc, source + other.gap_end_, source + other.GetCapacity(),
+                              array_.Get() + other.gap_begin_);
+    prefix.Release();
+  }
+
+  GapBuffer(GapBuffer &&other) noexcept
+      : array_(std::move(other.array_)),
+        gap_begin_(std::exchange(other.gap_begin_, 0)),
+        gap_end_(std::exchange(other.gap_end_, 0)) {
+  }
+
+  ~GapBuffer() {
+    DestroyElements();
+  }
+
+  // Аллокатор заменяется аллокатором rhs, только если этого требует
+  // propagate_on_container_copy_assignment
+  GapBuffer &operator=(const GapBuffer &rhs) {
+    if (this == &rhs) {
+      return *this;
+    }
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+      if (GetAllocator() != rhs.GetAllocator()) {
+        Clear();
+        array_.ReplaceAllocator(rhs.GetAllocator());
+        gap_begin_ = gap_end_ = 0;
+      }
+    }
+    GapBuffer copy(rhs, GetAllocator());
+    swap(copy);
+    return *this;
+  }
+
+  // Если аллокатор не передаётся (propagate_on_container_move_assignment == false)
+  // и аллокаторы не равны, забрать память rhs нельзя, и элементы перемещаются по одному
+  GapBuffer &operator=(GapBuffer &&rhs) noexcept(
+      AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+    if (this == &rhs) {
+      return *this;
+    }
+    if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+        && !AllocTraits::is_always_equal::value) {
+      if (GetAllocator() != rhs.GetAllocator()) {
+        Clear();
+        Reserve(rhs.GetSize());
+        auto &alloc = array_.GetAllocator();
+        Type *const source = rhs.array_.Get();
+        detail::ConstructionGuard prefix(alloc, array_.Get(),
+                                         detail::UninitializedMove(alloc, source, source + rhs.gap_begin_,
+                                                                   array_.Get()));
+        detail::UninitializedMove(alloc, source + rhs.gap_end_, source + rhs.GetCapacity(),
+                                  array_.Get() + rhs.gap_begin_);
+        prefix.Release();
+        gap_begin_ = rhs.GetSize();
+        gap_end_ = GetCapacity();
+        rhs.Clear();
+        return *this;
+      }
+    }
+    DestroyElements();
+    array_ = std::move(rhs.array_);
+    gap_begin_ = std::exchange(rhs.gap_begin_, 0);
+    gap_end_ = std::exchange(rhs.gap_end_, 0);
+    return *this;
+  }
+
+  // Возвращает копию аллокатора буфера
+  Allocator GetAllocator() const noexcept {
+    return array_.GetAllocator();
+  }
+
+  // Возвращает количество элементов
+  size_t GetSize() const noexcept {
+    return GetCapacity() - GetGapSize();
+  }
+
+  // Возвращает вместимость: число элементов, под которые выделена память, включая разрыв
+  size_t GetCapacity() const noexcept {
+    return array_.GetSize();
+  }
+
+  bool IsEmpty() const noexcept {
+    return GetSize() == 0;
+  }
+
+  // Возвращает номер элемента, перед которым стоит разрыв: вставка в эту позицию
+  // и удаление элемента в ней не перемещают элементов
+  size_t GetGapPosition() const noexcept {
+    return gap_begin_;
+  }
+
+  // Возвращает число свободных мест в разрыве
+  size_t GetGapSize() const noexcept {
+    return gap_end_ - gap_begin_;
+  }
+
+  // Сообщает, лежат ли элементы подряд с начала памяти (разрыв в конце)
+  bool IsCompact() const noexcept {
+    return gap_end_ == GetCapacity();
+  }
+
+  // Возвращает ссылку на элемент с индексом index
+  Type &operator[](size_t index) SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(index < GetSize(), "index is out of range");
+    return array_[Offset(index)];
+  }
+
+  const Type &operator[](size_t index) const SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(index < GetSize(), "index is out of range");
+    return array_[Offset(index)];
+  }
+
+  // Возвращает ссылку на элемент с индексом index
+  // Выбрасывает исключение std::out_of_range, если index >= size
+  Type &At(size_t index) {
+    if (index >= GetSize()) {
+      throw std::out_of_range("out_of_range");
+    }
+    return array_[Offset(index)];
+  }
+
+  const Type &At(size_t index) const {
+    if (index >= GetSize()) {
+      throw std::out_of_range("out_of_range");
+    }
+    return array_[Offset(index)];
+  }
+
+  // Разрушает все элементы, не изменяя вместимость. Весь буфер становится разрывом
+  void Clear() noexcept {
+    DestroyElements();
+    gap_begin_ = 0;
+    gap_end_ = GetCapacity();
+  }
+
+  // Добавляет элемент в конец буфера, перенося туда разрыв
+  void PushBack(const Type &item) {
+    EmplaceBack(item);
+  }
+
+  void PushBack(Type &&item) {
+    EmplaceBack(std::move(item));
+  }
+
+  template<typename... Args>
+  Type &EmplaceBack(Args &&... args) {
+    return *Emplace(cend(), std::forward<Args>(args)...);
+  }
+
+  // Вставляет значение value в позицию pos.
+  // Возвращает итератор на вставленное значение
+  Iterator Insert(ConstIterator pos, const Type &value) {
+    return Emplace(pos, value);
+  }
+
+  Iterator Insert(ConstIterator pos, Type &&value) {
+    return Emplace(pos, std::move(value));
+  }
+
+  // Создаёт элемент из аргументов args в позиции pos, перенося туда разрыв.
+  // Возвращает итератор на созданный элемент.
+  // В позиции разрыва элемент создаётся сразу на месте. Иначе элементы
+  // перемещаются, а args могут ссылаться на них, поэтому элемент сначала
+  // создаётся во временном объекте
+  template<typename... Args>
+  Iterator Emplace(ConstIterator pos, Args &&... args) {
+    const size_t index = IndexOf(pos);
+    if (index == gap_begin_ && gap_begin_ != gap_end_) {
+      AllocTraits::construct(array_.GetAllocator(), array_.Get() + gap_begin_, std::forward<Args>(args)...);
+    } else {
+      Type temp(std::forward<Args>(args)...);
+      PrepareGap(index, 1);
+      AllocTraits::construct(array_.GetAllocator(), array_.Get() + gap_begin_, std::move(temp));
+    }
+    ++gap_begin_;
+    return begin() + index;
+  }
+
+  // Вставляет в позицию pos count копий value.
+  // Возвращает итератор на первый вставленный элемент
+  Iterator Insert(ConstIterator pos, size_t count, const Type &value) {
+    const size_t index = IndexOf(pos);
+    // value может ссылаться на перемещаемый элемент буфера
+    const Type copy(value);
+    PrepareGap(index, count);
+    detail::UninitializedFill(array_.GetAllocator(), array_.Get() + gap_begin_, array_.Get() + gap_begin_ + count,
+                              copy);
+    gap_begin_ += count;
+    return begin() + index;
+  }
+
+  // Вставляет в позицию pos копии элементов [first, last), которые не должны
+  // принадлежать самому буферу. Возвращает итератор на первый вставленный элемент
+  template<typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+  Iterator Insert(ConstIterator pos, InputIt first, InputIt last) {
+    const size_t index = IndexOf(pos);
+    if constexpr (detail::kIsForwardIterator<InputIt>) {
+      const size_t count = std::distance(first, last);
+      PrepareGap(index, count);
+      detail::UninitializedCopy(array_.GetAllocator(), first, last, array_.Get() + gap_begin_);
+      gap_begin_ += count;
+    } else {
+      // Каждый следующий элемент вставляется в позицию разрыва
+      for (size_t offset = 0; first != last; ++first, ++offset) {
+        Emplace(cbegin() + (index + offset), *first);
+      }
+    }
+    return begin() + index;
+  }
+
+  // Добавляет в конец буфера копии элементов [first, last)
+  template<typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+  void Append(InputIt first, InputIt last) {
+    Insert(cend(), first, last);
+  }
+
+  // Удаляет элемент в позиции pos, перенося туда разрыв
+  Iterator Erase(ConstIterator pos) {
+    const size_t index = IndexOf(pos);
+    detail::Check(index < GetSize(), "Erase of end()");
+    assert(index < GetSize());
+    MoveGap(index);
+    AllocTraits::destroy(array_.GetAllocator(), array_.Get() + gap_end_);
+    ++gap_end_;
+    return begin() + index;
+  }
+
+  // Удаляет элементы [first, last): разрыв переносится в first и поглощает их
+  Iterator Erase(ConstIterator first, ConstIterator last) {
+    const size_t index = IndexOf(first);
+    const size_t last_index = IndexOf(last);
+    detail::Check(index <= last_index && last_index <= GetSize(), "Erase of invalid range");
+    assert(index <= last_index && last_index <= GetSize());
+    const size_t count = last_index - index;
+    if (count == 0) {
+      return begin() + index;
+    }
+    MoveGap(index);
+    detail::Destroy(array_.GetAllocator(), array_.Get() + gap_end_, array_.Get() + gap_end_ + count);
+    gap_end_ += count;
+    return begin() + index;
+  }
+
+  // Удаляет последний элемент. Буфер не должен быть пустым
+  void PopBack() {
+    detail::Check(!IsEmpty(), "PopBack of empty vector");
+    assert(!IsEmpty());
+    Erase(cend() - 1);
+  }
+
+  // Увеличивает вместимость до new_capacity. Разрыв остаётся на месте и увеличивается.
+  // Если перенос элементов бросает исключение, буфер остаётся прежним
+  void Reserve(size_t new_capacity) {
+    if (new_capacity > GetCapacity()) {
+      Reallocate(new_capacity);
+    }
+  }
+
+  // Переносит разрыв в конец буфера и возвращает его элементы, лежащие теперь подряд.
+  // Представление действительно до следующей вставки или удаления
+  SimpleSpan<Type> Compact() {
+    MoveGap(GetSize());
+    return SimpleSpan<Type>(array_.Get(), GetSize());
+  }
+
+  // Уменьшает вместимость до размера буфера, убирая разрыв
+  void ShrinkToFit() {
+    if (GetGapSize() == 0) {
+      return;
+    }
+    if (IsEmpty()) {
+      array_.Reset();
+      gap_begin_ = gap_end_ = 0;
+      return;
+    }
+    Reallocate(GetSize());
+  }
+
+  // Обменивает значение с другим буфером.
+  // Аллокаторы обмениваются, только если этого требует propagate_on_container_swap,
+  // иначе они должны быть равны
+  void swap(GapBuffer &other) noexcept {
+    assert(AllocTraits::propagate_on_container_swap::value || GetAllocator() == other.GetAllocator());
+    array_.swap(other.array_);
+    std::swap(gap_begin_, other.gap_begin_);
+    std::swap(gap_end_, other.gap_end_);
+  }
+
+  Iterator begin() noexcept {
+    return Iterator(this, 0);
+  }
+
+  Iterator end() noexcept {
+    return Iterator(this, GetSize());
+  }
+
+  ConstIterator begin() const noexcept {
+    return ConstIterator(this, 0);
+  }
+
+  ConstIterator end() const noexcept {
+    return ConstIterator(this, GetSize());
+  }
+
+  ConstIterator cbegin() const noexcept {
+    return begin();
+  }
+
+  ConstIterator cend() const noexcept {
+    return end();
+  }
+
+ private:
+  // Элементы поэлементно переносятся копированием байтов и не требуют разрушения
+  static constexpr bool kMovesBitwise =
+      detail::kCanCopyBitwise<Allocator, Type> && detail::kCanSkipDestroy<Allocator, Type>;
+
+  // Номер места в памяти для элемента с индексом index
+  size_t Offset(size_t index) const noexcept {
+    return index < gap_begin_ ? index : index + GetGapSize();
+  }
+
+  size_t IndexOf(ConstIterator pos) const noexcept {
+    assert(pos >= cbegin() && pos <= cend());
+    return pos.GetIndex();
+  }
+
+  // Переносит разрыв так, чтобы он начинался перед элементом index.
+  // Элементы переносятся по одному (move_if_noexcept), и после каждого шага буфер
+  // корректен, поэтому при исключении его содержимое не меняется
+  void MoveGap(size_t index) {
+    if (gap_begin_ == gap_end_) {
+      // Пустой разрыв можно поставить в любую позицию, ничего не перемещая
+      gap_begin_ = gap_end_ = index;
+      return;
+    }
+    Type *const data = array_.Get();
+    auto &alloc = array_.GetAllocator();
+    if (index < gap_begin_) {
+      const size_t count = gap_begin_ - index;
+      if constexpr (kMovesBitwise) {
+        std::memmove(data + gap_end_ - count, data + index, count * sizeof(Type));
+        gap_begin_ = index;
+        gap_end_ -= count;
+        return;
+      }
+      for (; gap_begin_ != index; --gap_begin_, --gap_end_) {
+        AllocTraits::construct(alloc, data + gap_end_ - 1, std::move_if_noexcept(data[gap_begin_ - 1]));
+        AllocTraits::destroy(alloc, data + gap_begin_ - 1);
+      }
+    } else if (index > gap_begin_) {
+      const size_t count = index - gap_begin_;
+      if constexpr (kMovesBitwise) {
+        std::memmove(data + gap_begin_, data + gap_end_, count * sizeof(Type));
+        gap_begin_ = index;
+        gap_end_ += count;
+        return;
+      }
+      for (; gap_begin_ != index; ++gap_begin_, ++gap_end_) {
+        AllocTraits::construct(alloc, data + gap_begin_, std::move_if_noexcept(data[gap_end_]));
+        AllocTraits::destroy(alloc, data + gap_end_);
+      }
+    }
+  }
+
+  // Переносит разрыв к элементу index и расширяет его не меньше чем до count мест
+  void PrepareGap(size_t index, size_t count) {
+    MoveGap(index);
+    if (GetGapSize() < count) {
+      Reallocate(GrowthPolicy::NextCapacity(GetCapacity(), GetSize() + count, sizeof(Type)));
+    }
+  }
+
+  // Выделяет память под new_capacity элементов и переносит в неё обе части,
+  // оставляя разрыв на прежней позиции (см. detail::UninitializedRelocate).
+  // Если перенос бросает исключение, буфер остаётся прежним
+  void Reallocate(size_t new_capacity) {
+    ArrayPtr<Type, Allocator> new_array(new_capacity, array_.GetAllocator());
+    auto &alloc = new_array.GetAllocator();
+    Type *const data = array_.Get();
+    Type *const new_data = new_array.Get();
+    const size_t suffix = GetCapacity() - gap_end_;
+    const size_t new_gap_end = new_capacity - suffix;
+
+    detail::ConstructionGuard prefix(alloc, new_data,
+                                     detail::UninitializedRelocate(alloc, data, data + gap_begin_, new_data));
+    detail::UninitializedRelocate(alloc, data + gap_end_, data + GetCapacity(), new_data + new_gap_end);
+    prefix.Release();
+
+    DestroyElements();
+    array_.swap(new_array);
+    gap_end_ = new_gap_end;
+  }
+
+  void DestroyElements() noexcept {
+    auto &alloc = array_.GetAllocator();
+    detail::Destroy(alloc, array_.Get(), array_.Get() + gap_begin_);
+    detail::Destroy(alloc, array_.Get() + gap_end_, array_.Get() + GetCapacity());
+  }
+
+  ArrayPtr<Type, Allocator> array_;
+  // Разрыв - места [gap_begin_, gap_end_) без элементов
+  size_t gap_begin_ = 0;
+  size_t gap_end_ = 0;
+};
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+bool operator==(const GapBuffer<Type, Allocator, GrowthPolicy> &lhs, const GapBuffer<Type, Allocator, GrowthPolicy> &rhs) {
+  return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+bool operator!=(const GapBuffer<Type, Allocator, GrowthPolicy> &lhs, const GapBuffer<Type, Allocator, GrowthPolicy> &rhs) {
+  return !(lhs == rhs);
+}
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+bool operator<(const GapBuffer<Type, Allocator, GrowthPolicy> &lhs, const GapBuffer<Type, Allocator, GrowthPolicy> &rhs) {
+  return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+bool operator<=(const GapBuffer<Type, Allocator, GrowthPolicy> &lhs, const GapBuffer<Type, Allocator, GrowthPolicy> &rhs) {
+  return !(rhs < lhs);
+}
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+bool operator>(const GapBuffer<Type, Allocator, GrowthPolicy> &lhs, const GapBuffer<Type, Allocator, GrowthPolicy> &rhs) {
+  return rhs < lhs;
+}
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+bool operator>=(const GapBuffer<Type, Allocator, GrowthPolicy> &lhs, const GapBuffer<Type, Allocator, GrowthPolicy> &rhs) {
+  return !(lhs < rhs);
+}
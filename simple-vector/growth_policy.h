@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+// Политики роста вместимости для SimpleVector.
+// Политика - тип со статическим методом
+//   size_t NextCapacity(size_t capacity, size_t required, size_t element_size),
+// который возвращает новую вместимость не меньше required, когда текущей
+// вместимости capacity не хватает для required элементов размера element_size
+
+namespace detail {
+
+// Наибольшая вместимость, байтовый размер которой помещается в size_t
+constexpr size_t MaxCapacity(size_t element_size) noexcept {
+  return std::numeric_limits<size_t>::max() / element_size;
+}
+
+// Умножает capacity на numerator / denominator без переполнения
+constexpr size_t ScaleCapacity(size_t capacity, size_t numerator, size_t denominator, size_t element_size) noexcept {
+  const size_t max_capacity = MaxCapacity(element_size);
+  if (capacity > max_capacity / numerator * denominator) {
+    return max_capacity;
+  }
+  return capacity / denominator * numerator + capacity % denominator * numerator / denominator;
+}
+
+}  // namespace detail
+
+// Увеличивает вместимость вдвое. Поведение SimpleVector по умолчанию
+struct DoublingGrowth {
+  static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+    return std::max(required, detail::ScaleCapacity(capacity, 2, 1, element_size));
+  }
+};
+
+// Увеличивает вместимость в полтора раза. Расходует меньше памяти, чем удвоение,
+// и позволяет аллокатору повторно использовать освобождённые ранее блоки
+struct OneAndHalfGrowth {
+  static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+    return std::max(required, detail::ScaleCapacity(capacity, 3, 2, element_size));
+  }
+};
+
+// Округляет вместимость вверх до степени двойки
+struct PowerOfTwoGrowth {
+  static constexpr size_t NextCapacity(size_t, size_t required, size_t element_size) noexcept {
+    size_t capacity = 1;
+    while (capacity < required) {
+      if (capacity > detail::MaxCapacity(element_size) / 2) {
+        return required;
+      }
+      capacity *= 2;
+    }
+    return capacity;
+  }
+};
+
+// Округляет размер блока памяти, который выбрала политика BasePolicy,
+// вверх до кратного PageSize байт, и использует всю округлённую память
+template<size_t PageSize = 4096, typename BasePolicy = DoublingGrowth>
+struct PageRoundedGrowth {
+  static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two");
+
+  static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+    const size_t base = BasePolicy::NextCapacity(capacity, required, element_size);
+    const size_t max_bytes = detail::MaxCapacity(1) - (PageSize - 1);
+    if (base > max_bytes / element_size) {
+      return base;
+    }
+    const size_t bytes = (base * element_size + PageSize - 1) & ~(PageSize - 1);
+    return bytes / element_size;
+  }
+};
+
+// Округляет размер блока до огромной страницы (2 МиБ)
+template<typename BasePolicy = DoublingGrowth>
+using HugePageGrowth = PageRoundedGrowth<size_t{2} << 20, BasePolicy>;
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace detail {
+
+// Итератор произвольного доступа по контейнеру Vector, хранящий указатель на контейнер
+// и номер элемента. Разыменование возвращает (*vector)[index] типа Reference.
+// Подходит контейнерам, элементы которых лежат не одним массивом (SoAVector, GapBuffer).
+// Reference может быть прокси, например кортежем ссылок на поля строки SoAVector:
+// тогда, как у std::vector<bool>, ссылка - не value_type &, и operator-> недоступен.
+// Vector должен объявлять ValueType и operator[]
+template<typename Vector, typename Reference>
+class IndexIterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename std::remove_const_t<Vector>::ValueType;
+  using difference_type = std::ptrdiff_t;
+  using pointer = std::conditional_t<std::is_reference_v<Reference>, std::remove_reference_t<Reference> *, void>;
+  using reference = Reference;
+
+  IndexIterator() noexcept = default;
+
+  IndexIterator(Vector *vector, size_t index) noexcept : vector_(vector), index_(index) {
+  }
+
+  // Iterator приводится к ConstIterator
+  template<typename OtherVector, typename OtherReference,
+      typename = std::enable_if_t<std::is_convertible_v<OtherVector *, Vector *>>>
+  IndexIterator(const IndexIterator<OtherVector, OtherReference> &other) noexcept
+      : vector_(other.vector_), index_(other.index_) {
+  }
+
+  // Номер элемента в контейнере
+  size_t GetIndex() const noexcept {
+    return index_;
+  }
+
+  Reference operator*() const {
+    return (*vector_)[index_];
+  }
+
+  template<typename Ref = Reference, typename = std::enable_if_t<std::is_reference_v<Ref>>>
+  pointer operator->() const {
+    return std::addressof((*vector_)[index_]);
+  }
+
+  Reference operator[](difference_type offset) const {
+    return (*vector_)[index_ + offset];
+  }
+
+  IndexIterator &operator++() noexcept {
+    ++index_;
+    return *this;
+  }
+
+  IndexIterator operator++(int) noexcept {
+    IndexIterator old = *this;
+    ++index_;
+    return old;
+  }
+
+  IndexIterator &operator--() noexcept {
+    --index_;
+    return *this;
+  }
+
+  IndexIterator operator--(int) noexcept {
+    IndexIterator old = *this;
+    --index_;
+    return old;
+  }
+
+  IndexIterator &operator+=(difference_type offset) noexcept {
+    index_ += offset;
+    return *this;
+  }
+
+  IndexIterator &operator-=(difference_type offset) noexcept {
+    index_ -= offset;
+    return *this;
+  }
+
+  friend IndexIterator operator+(IndexIterator it, difference_type offset) noexcept {
+    return it += offset;
+  }
+
+  friend IndexIterator operator+(difference_type offset, IndexIterator it) noexcept {
+    return it += offset;
+  }
+
+  friend IndexIterator operator-(IndexIterator it, difference_type offset) noexcept {
+    return it -= offset;
+  }
+
+  template<typename OtherVector, typename OtherReference>
+  difference_type operator-(const IndexIterator<OtherVector, OtherReference> &other) const noexcept {
+    return static_cast<difference_type>(index_ - other.GetIndex());
+  }
+
+  template<typename OtherVector, typename OtherReference>
+  bool operator==(const IndexIterator<OtherVector, OtherReference> &other) const noexcept {
+    return index_ == other.GetIndex();
+  }
+
+  template<typename OtherVector, typename OtherReference>
+  bool operator!=(const IndexIterator<OtherVector, OtherReference> &other) const noexcept {
+    return index_ != other.GetIndex();
+  }
+
+  template<typename OtherVector, typename OtherReference>
+  bool operator<(const IndexIterator<OtherVector, OtherReference> &other) const noexcept {
+    return index_ < other.GetIndex();
+  }
+
+  template<typename OtherVector, typename OtherReference>
+  bool operator<=(const IndexIterator<OtherVector, OtherReference> &other) const noexcept {
+    return index_ <= other.GetIndex();
+  }
+
+  template<typename OtherVector, typename OtherReference>
+  bool operator>(const IndexIterator<OtherVector, OtherReference> &other) const noexcept {
+    return index_ > other.GetIndex();
+  }
+
+  template<typename OtherVector, typename OtherReference>
+  bool operator>=(const IndexIterator<OtherVector, OtherReference> &other) const noexcept {
+    return index_ >= other.GetIndex();
+  }
+
+ private:
+  template<typename, typename>
+  friend class IndexIterator;
+
+  Vector *vector_ = nullptr;
+  size_t index_ = 0;
+};
+
+}  // namespace detail
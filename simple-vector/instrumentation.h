@@ -0,0 +1,251 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+// Политики инструментирования SimpleVector.
+// Вектор хранит объект политики и сообщает ему о событиях:
+//   OnAllocate(capacity, bytes) - выделен блок памяти под capacity элементов;
+//   OnMove(count)               - count элементов перемещены при перевыделении памяти
+//                                 или при сдвиге хвоста в Insert/Erase;
+//   OnCopy(count)               - count элементов скопированы при перевыделении памяти
+//                                 (если перемещение может бросить исключение)
+//                                 или при копировании вектора
+// Необязательные события для трассировки; политика без этих методов их не получает:
+//   OnReallocateBegin(old_capacity, new_capacity)
+//                               - вектор начинает перевыделение памяти;
+//   OnReallocateEnd(old_capacity, new_capacity, bytes_moved)
+//                               - элементы перенесены в новый блок;
+//                                 не вызывается, если перенос бросил исключение;
+//   OnShift(bytes)              - Insert/Erase сдвинули хвост вектора на месте
+
+// Инструментирование выключено. Пустой объект не занимает места в векторе,
+// а пустые встраиваемые методы не дают накладных расходов
+struct NoInstrumentation {
+  constexpr void OnAllocate(size_t, size_t) noexcept {
+  }
+  constexpr void OnMove(size_t) noexcept {
+  }
+  constexpr void OnCopy(size_t) noexcept {
+  }
+};
+
+namespace detail {
+
+template<typename Instrumentation, typename = void>
+struct HasReallocationHooks : std::false_type {
+};
+
+template<typename Instrumentation>
+struct HasReallocationHooks<Instrumentation, std::void_t<
+    decltype(std::declval<Instrumentation &>().OnReallocateBegin(size_t(), size_t())),
+    decltype(std::declval<Instrumentation &>().OnReallocateEnd(size_t(), size_t(), size_t()))>> : std::true_type {
+};
+
+template<typename Instrumentation, typename = void>
+struct HasShiftHook : std::false_type {
+};
+
+template<typename Instrumentation>
+struct HasShiftHook<Instrumentation, std::void_t<decltype(std::declval<Instrumentation &>().OnShift(size_t()))>>
+    : std::true_type {
+};
+
+template<typename Instrumentation>
+constexpr void NotifyReallocateBegin(Instrumentation &instrumentation, size_t old_capacity,
+                                     size_t new_capacity) noexcept {
+  if constexpr (HasReallocationHooks<Instrumentation>::value) {
+    instrumentation.OnReallocateBegin(old_capacity, new_capacity);
+  }
+}
+
+template<typename Instrumentation>
+constexpr void NotifyReallocateEnd(Instrumentation &instrumentation, size_t old_capacity, size_t new_capacity,
+                                   size_t bytes_moved) noexcept {
+  if constexpr (HasReallocationHooks<Instrumentation>::value) {
+    instrumentation.OnReallocateEnd(old_capacity, new_capacity, bytes_moved);
+  }
+}
+
+template<typename Instrumentation>
+constexpr void NotifyShift(Instrumentation &instrumentation, size_t bytes) noexcept {
+  if constexpr (HasShiftHook<Instrumentation>::value) {
+    instrumentation.OnShift(bytes);
+  }
+}
+
+}  // namespace detail
+
+// Счётчики выделений памяти и переносов элементов
+struct InstrumentationCounters {
+  size_t allocations = 0;
+  size_t bytes_allocated = 0;
+  size_t elements_moved = 0;
+  size_t elements_copied = 0;
+  size_t peak_capacity = 0;
+};
+
+inline std::ostream &operator<<(std::ostream &out, const InstrumentationCounters &counters) {
+  return out << "allocations=" << counters.allocations
+             << " bytes_allocated=" << counters.bytes_allocated
+             << " elements_moved=" << counters.elements_moved
+             << " elements_copied=" << counters.elements_copied
+             << " peak_capacity=" << counters.peak_capacity;
+}
+
+// Считает события отдельно для каждого вектора и суммарно для всех векторов
+// с этой политикой. Глобальные счётчики потокобезопасны
+class CountingInstrumentation {
+ public:
+  void OnAllocate(size_t capacity, size_t bytes) noexcept {
+    ++counters_.allocations;
+    counters_.bytes_allocated += bytes;
+    counters_.peak_capacity = std::max(counters_.peak_capacity, capacity);
+
+    global_allocations_.fetch_add(1, std::memory_order_relaxed);
+    global_bytes_allocated_.fetch_add(bytes, std::memory_order_relaxed);
+    size_t peak = global_peak_capacity_.load(std::memory_order_relaxed);
+    while (peak < capacity
+        && !global_peak_capacity_.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {
+    }
+  }
+
+  void OnMove(size_t count) noexcept {
+    counters_.elements_moved += count;
+    global_elements_moved_.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  void OnCopy(size_t count) noexcept {
+    counters_.elements_copied += count;
+    global_elements_copied_.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  // Возвращает счётчики этого вектора
+  const InstrumentationCounters &GetCounters() const noexcept {
+    return counters_;
+  }
+
+  // Возвращает сумму счётчиков всех векторов; peak_capacity - наибольшая вместимость
+  static InstrumentationCounters GetGlobalCounters() noexcept {
+    InstrumentationCounters counters;
+    counters.allocations = global_allocations_.load(std::memory_order_relaxed);
+    counters.bytes_allocated = global_bytes_allocated_.load(std::memory_order_relaxed);
+    counters.elements_moved = global_elements_moved_.load(std::memory_order_relaxed);
+    counters.elements_copied = global_elements_copied_.load(std::memory_order_relaxed);
+    counters.peak_capacity = global_peak_capacity_.load(std::memory_order_relaxed);
+    return counters;
+  }
+
+  static void ResetGlobalCounters() noexcept {
+    global_allocations_ = 0;
+    global_bytes_allocated_ = 0;
+    global_elements_moved_ = 0;
+    global_elements_copied_ = 0;
+    global_peak_capacity_ = 0;
+  }
+
+ private:
+  InstrumentationCounters counters_;
+
+  inline static std::atomic<size_t> global_allocations_ = 0;
+  inline static std::atomic<size_t> global_bytes_allocated_ = 0;
+  inline static std::atomic<size_t> global_elements_moved_ = 0;
+  inline static std::atomic<size_t> global_elements_copied_ = 0;
+  inline static std::atomic<size_t> global_peak_capacity_ = 0;
+};
+
+// Выводит счётчики вектора с политикой CountingInstrumentation, а также его размер,
+// вместимость и неиспользуемую вместимость (capacity - size)
+template<typename Vector>
+void DumpInstrumentation(std::ostream &out, const Vector &v) {
+  out << v.GetInstrumentation().GetCounters()
+      << " size=" << v.GetSize()
+      << " capacity=" << v.GetCapacity()
+      << " wasted_capacity=" << v.GetCapacity() - v.GetSize();
+}
+
+// Событие вектора с политикой TracingInstrumentation
+struct TraceEvent {
+  enum class Kind {
+    kReallocation,
+    kShift,
+  };
+
+  Kind kind = Kind::kReallocation;
+  // Вместимость до и после перевыделения; для сдвига не заполняются
+  size_t old_capacity = 0;
+  size_t new_capacity = 0;
+  // Число перенесённых или сдвинутых байт
+  size_t bytes = 0;
+  // Длительность перевыделения вместе с выделением памяти; для сдвига - 0
+  std::chrono::nanoseconds duration{0};
+};
+
+// Передаёт обработчику перевыделения памяти и сдвиги хвоста не меньше порога.
+// Обработчик и порог задаются для текущего потока и действуют на все векторы
+// с этой политикой; без обработчика политика только проверяет указатель.
+// Обработчик вызывается внутри методов вектора и не должен бросать исключения и изменять вектор
+class TracingInstrumentation {
+ public:
+  using Handler = void (*)(const TraceEvent &event, void *context);
+
+  static constexpr size_t kDefaultShiftThreshold = 4096;
+
+  // Устанавливает обработчик событий векторов текущего потока; nullptr выключает трассировку
+  static void SetHandler(Handler handler, void *context = nullptr) noexcept {
+    handler_ = handler;
+    context_ = context;
+  }
+
+  // Сдвиги меньше bytes байт обработчику не передаются
+  static void SetShiftThreshold(size_t bytes) noexcept {
+    shift_threshold_ = bytes;
+  }
+
+  void OnAllocate(size_t, size_t) noexcept {
+  }
+  void OnMove(size_t) noexcept {
+  }
+  void OnCopy(size_t) noexcept {
+  }
+
+  void OnReallocateBegin(size_t, size_t) noexcept {
+    if (handler_ != nullptr) {
+      begin_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  void OnReallocateEnd(size_t old_capacity, size_t new_capacity, size_t bytes_moved) noexcept {
+    if (handler_ != nullptr) {
+      const auto duration = std::chrono::steady_clock::now() - begin_;
+      handler_(TraceEvent{TraceEvent::Kind::kReallocation, old_capacity, new_capacity, bytes_moved,
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(duration)},
+               context_);
+    }
+  }
+
+  void OnShift(size_t bytes) noexcept {
+    if (handler_ != nullptr && bytes >= shift_threshold_) {
+      handler_(TraceEvent{TraceEvent::Kind::kShift, 0, 0, bytes, {}}, context_);
+    }
+  }
+
+ private:
+  std::chrono::steady_clock::time_point begin_;
+
+  inline static thread_local Handler handler_ = nullptr;
+  inline static thread_local void *context_ = nullptr;
+  inline static thread_local size_t shift_threshold_ = kDefaultShiftThreshold;
+};
+
+// Политика инструментирования векторов, у которых она не указана явно.
+// Чтобы инструментировать все такие векторы, достаточно собрать программу
+// с -DSIMPLE_VECTOR_DEFAULT_INSTRUMENTATION=CountingInstrumentation
+#ifndef SIMPLE_VECTOR_DEFAULT_INSTRUMENTATION
+#define SIMPLE_VECTOR_DEFAULT_INSTRUMENTATION NoInstrumentation
+#endif
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "simple_vector.h"
+#include "vector_io.h"
+
+// Завершённая операция IoUringQueue
+struct IoCompletion {
+  // Значение, переданное при постановке операции в очередь
+  uint64_t user_data = 0;
+  // Число записанных или прочитанных байт либо -errno, если операция не удалась
+  int result = 0;
+};
+
+// Очередь асинхронного ввода-вывода через io_uring прямо в память векторов.
+// Операции копятся в очереди отправки, пока Submit() не передаст их ядру одним системным
+// вызовом, а WaitCompletion() забирает завершённые. Чтение, как и ReadVectored, резервирует
+// память заранее и увеличивает размер вектора, когда операция завершится.
+// Пока операция не завершилась, её вектор нельзя изменять и разрушать.
+// Операции выполняются в любом порядке; для сокетов и каналов offset должен быть kCurrentOffset.
+// Используются системные вызовы напрямую, без liburing
+class IoUringQueue {
+ public:
+  // Смещение для файлов без позиционирования и для текущей позиции файла
+  static constexpr uint64_t kCurrentOffset = ~uint64_t(0);
+
+  // Создаёт очередь на entries операций отправки.
+  // Бросает std::system_error, если ядро не поддерживает io_uring или запрещает его
+  explicit IoUringQueue(unsigned entries = 64) {
+    io_uring_params params{};
+    ring_fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (ring_fd_ < 0) {
+      ThrowSystemError("io_uring_setup");
+    }
+    try {
+      MapRings(params);
+      pending_.Resize(cq_entries_);
+      free_slots_.Reserve(cq_entries_);
+    } catch (...) {
+      Close();
+      throw;
+    }
+    for (unsigned slot = cq_entries_; slot > 0; --slot) {
+      free_slots_.PushBack(slot - 1);
+    }
+  }
+
+  IoUringQueue(const IoUringQueue &) = delete;
+  IoUringQueue &operator=(const IoUringQueue &) = delete;
+
+  // Незавершённые операции продолжают работать с памятью векторов,
+  // поэтому перед разрушением очереди их нужно дождаться
+  ~IoUringQueue() {
+    assert(GetInFlight() == 0);
+    Close();
+  }
+
+  // Наибольшее число одновременно незавершённых операций
+  size_t GetCapacity() const noexcept {
+    return pending_.GetSize();
+  }
+
+  // Число поставленных в очередь и ещё не забранных WaitCompletion() операций
+  size_t GetInFlight() const noexcept {
+    return pending_.GetSize() - free_slots_.GetSize();
+  }
+
+  // Ставит в очередь запись элементов buffer в fd начиная со смещения offset.
+  // Бросает std::length_error, если незавершённых операций уже GetCapacity()
+  template<typename Buffer>
+  void PrepareWrite(int fd, const Buffer &buffer, uint64_t offset, uint64_t user_data) {
+    PendingOperation &operation = AcquireSlot(user_data);
+    operation.io = detail::MakeWriteIoVector(buffer);
+    PushSubmission(IORING_OP_WRITEV, fd, offset, operation);
+  }
+
+  // Ставит в очередь чтение из fd со смещения offset в target (см. ReadInto).
+  // Размер вектора увеличивается на число прочитанных целых элементов при завершении операции.
+  // Бросает std::length_error, если незавершённых операций уже GetCapacity()
+  template<typename Vector>
+  void PrepareRead(int fd, const ReadTarget<Vector> &target, uint64_t offset, uint64_t user_data) {
+    PendingOperation &operation = AcquireSlot(user_data);
+    try {
+      operation.io = detail::MakeReadIoVector(target);
+    } catch (...) {
+      ReleaseSlot(operation);
+      throw;
+    }
+    operation.vector = &target.vector;
+    operation.count = target.count;
+    operation.commit = [](void *vector, size_t count, size_t bytes) {
+      detail::CommitRead(ReadTarget<Vector>{*static_cast<Vector *>(vector), count}, bytes);
+    };
+    PushSubmission(IORING_OP_READV, fd, offset, operation);
+  }
+
+  // Передаёт ядру все поставленные операции одним системным вызовом.
+  // Возвращает число переданных операций. Бросает std::system_error при ошибке
+  size_t Submit() {
+    return Enter(0, 0);
+  }
+
+  // Передаёт ядру поставленные операции и ждёт завершения одной из них.
+  // Незавершённых операций должно быть больше нуля. Бросает std::system_error при ошибке
+  IoCompletion WaitCompletion() {
+    assert(GetInFlight() > 0);
+    io_uring_cqe *cqe = PeekCompletion();
+    while (cqe == nullptr) {
+      Enter(1, IORING_ENTER_GETEVENTS);
+      cqe = PeekCompletion();
+    }
+    PendingOperation &operation = pending_[cqe->user_data];
+    const IoCompletion completion{operation.user_data, cqe->res};
+    __atomic_store_n(cq_head_, *cq_head_ + 1, __ATOMIC_RELEASE);
+    if (operation.commit && completion.result > 0) {
+      operation.commit(operation.vector, operation.count, static_cast<size_t>(completion.result));
+    }
+    ReleaseSlot(operation);
+    return completion;
+  }
+
+ private:
+  // Незавершённая операция. Описание памяти хранится здесь, потому что ядро
+  // может читать его до завершения операции
+  struct PendingOperation {
+    iovec io{};
+    uint64_t user_data = 0;
+    // Вектор чтения и функция, увеличивающая его размер на прочитанные элементы
+    void *vector = nullptr;
+    size_t count = 0;
+    void (*commit)(void *vector, size_t count, size_t bytes) = nullptr;
+  };
+
+  [[noreturn]] static void ThrowSystemError(const char *operation) {
+    throw std::system_error(errno, std::generic_category(), operation);
+  }
+
+  static void *MapRing(int fd, size_t bytes, uint64_t offset) {
+    void *mapping = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                           static_cast<off_t>(offset));
+    if (mapping == MAP_FAILED) {
+      ThrowSystemError("mmap");
+    }
+    return mapping;
+  }
+
+  void MapRings(const io_uring_params &params) {
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    // Начиная с Linux 5.4 обе очереди лежат в одном отображении
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = MapRing(ring_fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+    cq_ring_ = single_mmap ? sq_ring_ : MapRing(ring_fd_, cq_ring_size_, IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe *>(MapRing(ring_fd_, sqes_size_, IORING_OFF_SQES));
+
+    char *sq = static_cast<char *>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+
+    char *cq = static_cast<char *>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    cq_entries_ = params.cq_entries;
+  }
+
+  PendingOperation &AcquireSlot(uint64_t user_data) {
+    if (free_slots_.IsEmpty()) {
+      throw std::length_error("too many io_uring operations in flight");
+    }
+    const unsigned slot = free_slots_[free_slots_.GetSize() - 1];
+    free_slots_.PopBack();
+    pending_[slot] = PendingOperation{};
+    pending_[slot].user_data = user_data;
+    return pending_[slot];
+  }
+
+  void ReleaseSlot(PendingOperation &operation) noexcept {
+    // Вместимость free_slots_ зарезервирована под все слоты, поэтому PushBack не выделяет память
+    free_slots_.PushBack(static_cast<unsigned>(&operation - pending_.Data()));
+  }
+
+  // Записывает операцию в очередь отправки. Если очередь заполнена,
+  // сначала передаёт ядру уже поставленные операции
+  void PushSubmission(uint8_t opcode, int fd, uint64_t offset, PendingOperation &operation) {
+    unsigned tail = *sq_tail_;
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) == sq_entries_) {
+      try {
+        Submit();
+      } catch (...) {
+        ReleaseSlot(operation);
+        throw;
+      }
+    }
+    const unsigned index = tail & sq_mask_;
+    io_uring_sqe &sqe = sqes_[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = opcode;
+    sqe.fd = fd;
+    sqe.off = offset;
+    sqe.addr = reinterpret_cast<uint64_t>(&operation.io);
+    sqe.len = 1;
+    sqe.user_data = static_cast<uint64_t>(&operation - pending_.Data());
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    ++unsubmitted_;
+  }
+
+  io_uring_cqe *PeekCompletion() noexcept {
+    const unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      return nullptr;
+    }
+    return &cqes_[head & cq_mask_];
+  }
+
+  // Передаёт ядру неотправленные операции и ждёт min_complete завершений
+  size_t Enter(unsigned min_complete, unsigned flags) {
+    while (true) {
+      const long submitted = ::syscall(__NR_io_uring_enter, ring_fd_, unsubmitted_, min_complete, flags, nullptr, 0);
+      if (submitted >= 0) {
+        unsubmitted_ -= static_cast<unsigned>(submitted);
+        return static_cast<size_t>(submitted);
+      }
+      if (errno != EINTR) {
+        ThrowSystemError("io_uring_enter");
+      }
+    }
+  }
+
+  void Close() noexcept {
+    if (sqes_) {
+      ::munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_) {
+      ::munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_) {
+      ::munmap(sq_ring_, sq_ring_size_);
+    }
+    if (ring_fd_ >= 0) {
+      ::close(ring_fd_);
+    }
+  }
+
+  int ring_fd_ = -1;
+  void *sq_ring_ = nullptr;
+  void *cq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  size_t cq_ring_size_ = 0;
+  io_uring_sqe *sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  unsigned *sq_head_ = nullptr;
+  unsigned *sq_tail_ = nullptr;
+  unsigned *sq_array_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  unsigned unsubmitted_ = 0;
+
+  unsigned *cq_head_ = nullptr;
+  unsigned *cq_tail_ = nullptr;
+  io_uring_cqe *cqes_ = nullptr;
+  unsigned cq_mask_ = 0;
+  unsigned cq_entries_ = 0;
+
+  // Слот операции передаётся ядру как user_data и возвращается в завершении
+  SimpleVector<PendingOperation> pending_;
+  SimpleVector<unsigned> free_slots_;
+};
@@ -1,9 +1,35 @@
+#include "concurrent_simple_vector.h"
+#include "cow_simple_vector.h"
+#include "gap_buffer.h"
+#include "io_uring_queue.h"
+#include "mapped_vector.h"
+#include "parallel_algorithms.h"
+#include "segmented_vector.h"
+#include "serialization.h"
+#include "simple_span.h"
 #include "simple_vector.h"
+#include "small_vector.h"
+#include "soa_vector.h"
+#include "vector_io.h"
 
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
 #include <numeric>
+#include <sstream>
 #include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace std;
 
@@ -30,6 +56,142 @@ class X {
   size_t x_;
 };
 
+// Считает создания и разрушения своих объектов
+class Counted {
+ public:
+  inline static size_t constructed = 0;
+  inline static size_t destroyed = 0;
+
+  static void ResetCounters() {
+    constructed = 0;
+    destroyed = 0;
+  }
+
+  Counted() {
+    ++constructed;
+  }
+  Counted(const Counted &) {
+    ++constructed;
+  }
+  Counted(Counted &&) noexcept {
+    ++constructed;
+  }
+  Counted &operator=(const Counted &) = default;
+  Counted &operator=(Counted &&) = default;
+  ~Counted() {
+    ++destroyed;
+  }
+};
+
+// Тип без конструктора по умолчанию
+class NoDefault {
+ public:
+  explicit NoDefault(int value) : value_(value) {
+  }
+  int GetValue() const {
+    return value_;
+  }
+
+ private:
+  int value_;
+};
+
+// Аллокатор с состоянием, считающий выделения памяти.
+// Передаётся при перемещающем присваивании и при обмене
+template<typename Type>
+class TrackingAllocator {
+ public:
+  using value_type = Type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  explicit TrackingAllocator(int id, size_t *allocations) : id_(id), allocations_(allocations) {
+  }
+  template<typename Other>
+  TrackingAllocator(const TrackingAllocator<Other> &other) : id_(other.id_), allocations_(other.allocations_) {
+  }
+
+  Type *allocate(size_t n) {
+    ++*allocations_;
+    return std::allocator<Type>().allocate(n);
+  }
+  void deallocate(Type *p, size_t n) {
+    std::allocator<Type>().deallocate(p, n);
+  }
+
+  int GetId() const {
+    return id_;
+  }
+
+  bool operator==(const TrackingAllocator &other) const {
+    return id_ == other.id_;
+  }
+  bool operator!=(const TrackingAllocator &other) const {
+    return !(*this == other);
+  }
+
+ private:
+  template<typename Other>
+  friend class TrackingAllocator;
+
+  int id_;
+  size_t *allocations_;
+};
+
+// Аллокатор, который кроме того передаётся при копирующем присваивании
+template<typename Type>
+class CopyPropagatingAllocator : public TrackingAllocator<Type> {
+ public:
+  using propagate_on_container_copy_assignment = std::true_type;
+  using TrackingAllocator<Type>::TrackingAllocator;
+};
+
+// Копирование бросает исключение, когда исчерпан бюджет copies_left.
+// Перемещение не помечено noexcept
+class ThrowingCopy {
+ public:
+  inline static int copies_left = 0;
+
+  explicit ThrowingCopy(int value) : value_(value) {
+  }
+  ThrowingCopy(const ThrowingCopy &other) : value_(other.value_) {
+    if (copies_left-- <= 0) {
+      throw runtime_error("copy failed");
+    }
+  }
+  ThrowingCopy(ThrowingCopy &&other) : value_(exchange(other.value_, -1)) {
+  }
+  ThrowingCopy &operator=(const ThrowingCopy &) = default;
+  ThrowingCopy &operator=(ThrowingCopy &&) = default;
+
+  int GetValue() const {
+    return value_;
+  }
+
+ private:
+  int value_;
+};
+
+// Конструктор по умолчанию бросает исключение, когда исчерпан запас constructions_left.
+// Счётчики атомарные, потому что объекты создаются из нескольких потоков
+class ThrowingDefault {
+ public:
+  inline static atomic<size_t> alive = 0;
+  inline static atomic<size_t> constructions_left = 0;
+
+  ThrowingDefault() {
+    if (constructions_left.fetch_sub(1) == 0) {
+      throw runtime_error("construction failed");
+    }
+    ++alive;
+  }
+  ThrowingDefault(const ThrowingDefault &) = delete;
+  ThrowingDefault &operator=(const ThrowingDefault &) = delete;
+  ~ThrowingDefault() {
+    --alive;
+  }
+};
+
 SimpleVector<int> GenerateVector(size_t size) {
   SimpleVector<int> v(size);
   iota(v.begin(), v.end(), 1);
@@ -172,6 +334,66 @@ void TestResize() {
     v.Resize(old_size + 2);
     assert(v[3] == 0);
   }
+
+  // Новые элементы - копии value, даже если value - элемент самого вектора
+  {
+    SimpleVector<string> v{"a"s, "a long string that does not fit into SSO"s};
+    v.Resize(5, v[1]);
+    assert(v.GetSize() == 5);
+    assert(v[4] == "a long string that does not fit into SSO"s && v[1] == v[4]);
+    v.Reserve(10);
+    v.Resize(8, v[0]);
+    assert(v.GetSize() == 8 && v[7] == "a"s);
+    v.Resize(1, "b"s);
+    assert((v == SimpleVector<string>{"a"s}));
+  }
+
+  // Инициализация по умолчанию не обнуляет элементы тривиальных типов
+  {
+    SimpleVector<unsigned char> v{1, 2, 3};
+    v.Resize(1);
+    v.ResizeUninitialized(3);
+    assert(v.GetSize() == 3 && v[1] == 2 && v[2] == 3);
+    v.ResizeUninitialized(100);
+    assert(v.GetSize() == 100 && v[0] == 1 && v[2] == 3);
+    fill(v.begin() + 3, v.end(), 7);
+    assert(v[99] == 7);
+
+    SimpleVector<string> strings{"a"s};
+    strings.ResizeDefaultInit(3);
+    assert(strings.GetSize() == 3 && strings[0] == "a"s && strings[2].empty());
+  }
+
+  // Если создание элемента бросает исключение, вектор остаётся прежним
+  {
+    ThrowingCopy::copies_left = 100;
+    SimpleVector<ThrowingCopy> v;
+    v.PushBack(ThrowingCopy(1));
+    v.PushBack(ThrowingCopy(2));
+    const auto *old_data = v.Data();
+    ThrowingCopy::copies_left = 1;
+    try {
+      v.Resize(5, ThrowingCopy(0));
+      assert(false);
+    } catch (const runtime_error &) {
+    }
+    assert(v.GetSize() == 2 && v.Data() == old_data && v[1].GetValue() == 2);
+    ThrowingCopy::copies_left = 100;
+  }
+
+  {
+    SmallVector<string, 2> v{"a"s};
+    v.Resize(2, v[0]);
+    assert(v.IsInline() && v[1] == "a"s);
+    v.Resize(6, v[1]);
+    assert(!v.IsInline() && v.GetSize() == 6 && v[5] == "a"s);
+    v.ResizeDefaultInit(8);
+    assert(v[7].empty());
+    SmallVector<int, 4> numbers{1, 2, 3};
+    numbers.Resize(1);
+    numbers.ResizeUninitialized(3);
+    assert(numbers[2] == 3);
+  }
   cout << "Done!"s << endl << endl;
 }
 
@@ -180,14 +402,14 @@ void TestIterators() {
   cout << "Test iterators"s << endl;
   {
     SimpleVector<int> v;
-    assert(v.begin() == nullptr);
-    assert(v.end() == nullptr);
+    assert(v.Data() == nullptr);
+    assert(v.Data() + v.GetSize() == nullptr);
   }
 
   // Непустой вектор
   {
     SimpleVector<int> v(10, 42);
-    assert(v.begin());
+    assert(v.Data());
     assert(*v.begin() == 42);
     assert(v.end() == v.begin() + v.GetSize());
   }
@@ -245,6 +467,53 @@ void TestComparison() {
   cout << "Done!"s << endl << endl;
 }
 
+template<typename Type>
+void CheckComparisonMatchesStd() {
+  // Различие в каждой позиции, в том числе в хвосте, который не попадает в SIMD-регистр
+  for (size_t size = 0; size <= 100; ++size) {
+    SimpleVector<Type> a(size);
+    for (size_t i = 0; i < size; ++i) {
+      a[i] = static_cast<Type>(i % 7);
+    }
+    for (size_t pos = 0; pos < size; ++pos) {
+      for (int delta : {-1, 1}) {
+        SimpleVector<Type> b(a);
+        b[pos] = static_cast<Type>(b[pos] + delta);
+        assert((a == b) == equal(a.begin(), a.end(), b.begin(), b.end()));
+        assert((a < b) == lexicographical_compare(a.begin(), a.end(), b.begin(), b.end()));
+        assert((b < a) == lexicographical_compare(b.begin(), b.end(), a.begin(), a.end()));
+      }
+    }
+    SimpleVector<Type> copy(a);
+    assert(a == copy && !(a < copy) && !(copy < a));
+  }
+}
+
+void TestSimdComparison() {
+  cout << "Test SIMD comparison"s << endl;
+  CheckComparisonMatchesStd<uint8_t>();
+  CheckComparisonMatchesStd<signed char>();
+  CheckComparisonMatchesStd<int>();
+  CheckComparisonMatchesStd<int64_t>();
+  CheckComparisonMatchesStd<double>();
+
+  // Сначала сравниваются размеры: правый вектор короче и не читается за своим концом
+  SimpleVector<int> longer{1, 2, 3};
+  SimpleVector<int> shorter{1, 2};
+  assert(longer != shorter && shorter != longer);
+  assert(shorter < longer && !(longer < shorter));
+  assert((SimpleVector<int>() == SimpleVector<int>()));
+  assert((SimpleVector<int>() < SimpleVector<int>{0}));
+
+  // Знаковые элементы сравниваются как числа, а не как байты
+  assert((SimpleVector<int>{-1} < SimpleVector<int>{1}));
+  assert((SimpleVector<signed char>{-1} < SimpleVector<signed char>{1}));
+  assert((SimpleVector<int>{256} > SimpleVector<int>{1}));
+  // 0.0 == -0.0, хотя их байты различаются
+  assert((SimpleVector<double>{0.0} == SimpleVector<double>{-0.0}));
+  cout << "Done!"s << endl << endl;
+}
+
 void TestSwap() {
   // Обмен значений векторов
   cout << "Test swap method"s << endl;
@@ -297,16 +566,183 @@ void TestInsert() {
 void TestErase() {
   // Удаление элементов
   cout << "Test erase method"s << endl;
-  SimpleVector<int> v{1, 2, 3, 4};
-  v.Erase(v.cbegin() + 2);
-  assert((v == SimpleVector<int>{1, 2, 4}));
+  {
+    SimpleVector<int> v{1, 2, 3, 4};
+    v.Erase(v.cbegin() + 2);
+    assert((v == SimpleVector<int>{1, 2, 4}));
+  }
+  {
+    // Удаление диапазона сдвигает хвост один раз
+    SimpleVector<string> v{"a"s, "b"s, "c"s, "d"s, "e"s};
+    auto it = v.Erase(v.cbegin() + 1, v.cbegin() + 3);
+    assert(*it == "d"s && (v == SimpleVector<string>{"a"s, "d"s, "e"s}));
+    it = v.Erase(v.cbegin() + 1, v.cbegin() + 1);
+    assert(*it == "d"s && v.GetSize() == 3);
+    it = v.Erase(v.cbegin() + 1, v.cend());
+    assert(it == v.end() && (v == SimpleVector<string>{"a"s}));
+  }
+  {
+    // EraseIf удаляет элементы за один проход, сохраняя порядок остальных
+    SimpleVector<int, std::allocator<int>, DoublingGrowth, CountingInstrumentation> v{1, 2, 3, 4, 5, 6, 7, 8};
+    assert(v.EraseIf([](int x) {
+      return x % 2 == 0;
+    }) == 4);
+    assert(v.GetSize() == 4 && v[0] == 1 && v[1] == 3 && v[2] == 5 && v[3] == 7);
+    // Каждый оставшийся элемент перемещается не больше одного раза
+    assert(v.GetInstrumentation().GetCounters().elements_moved == 3);
+    assert(v.EraseIf([](int) {
+      return false;
+    }) == 0 && v.GetSize() == 4);
+    assert(v.EraseIf([](int) {
+      return true;
+    }) == 4 && v.IsEmpty());
+  }
+  {
+    Counted::ResetCounters();
+    {
+      SimpleVector<Counted> v(10);
+      size_t index = 0;
+      v.EraseIf([&index](const Counted &) {
+        return index++ % 3 == 0;
+      });
+      assert(v.GetSize() == 6);
+      v.Erase(v.begin(), v.begin() + 2);
+    }
+    assert(Counted::constructed == Counted::destroyed);
+  }
+  {
+    // UnorderedErase ставит на место удалённого последний элемент
+    SimpleVector<string> v{"a"s, "b"s, "c"s, "d"s};
+    auto it = v.UnorderedErase(v.cbegin() + 1);
+    assert(*it == "d"s && (v == SimpleVector<string>{"a"s, "d"s, "c"s}));
+    it = v.UnorderedErase(v.cend() - 1);
+    assert(it == v.end() && (v == SimpleVector<string>{"a"s, "d"s}));
+  }
+  {
+    SmallVector<int, 4> v{1, 2, 3, 4, 5, 6};
+    v.Erase(v.begin() + 1, v.begin() + 3);
+    assert(v.GetSize() == 4 && v[1] == 4);
+    assert(v.EraseIf([](int x) {
+      return x > 4;
+    }) == 2);
+    v.UnorderedErase(v.begin());
+    assert(v.GetSize() == 1 && v[0] == 4);
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestShrinkToFit() {
+  cout << "Test shrink to fit and reset"s << endl;
+  {
+    SimpleVector<string> v(Reserve(100));
+    v.PushBack("a"s);
+    v.PushBack("b"s);
+    v.ShrinkToFit();
+    assert(v.GetCapacity() == 2);
+    assert((v == SimpleVector<string>{"a"s, "b"s}));
+    v.Clear();
+    v.ShrinkToFit();
+    assert(v.GetCapacity() == 0);
+    assert(v.Data() == nullptr);
+    v.PushBack("c"s);
+    assert(v.GetCapacity() == 1);
+  }
+
+  {
+    Counted::ResetCounters();
+    SimpleVector<Counted> v(10);
+    v.Reset();
+    assert(v.IsEmpty());
+    assert(v.GetCapacity() == 0);
+    assert(Counted::destroyed == 10);
+    v.Resize(3);
+    assert(v.GetSize() == 3 && v.GetCapacity() == 3);
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestRangeOperations() {
+  cout << "Test range insertion and assignment"s << endl;
+  const string source[] = {"x"s, "y"s, "z"s};
+
+  // Вставка диапазона в середину без перевыделения памяти: хвост длиннее и короче диапазона
+  {
+    SimpleVector<string> v{"a"s, "b"s, "c"s, "d"s, "e"s};
+    v.Reserve(20);
+    auto it = v.Insert(v.begin() + 1, begin(source), end(source));
+    assert(it == v.begin() + 1);
+    assert((v == SimpleVector<string>{"a"s, "x"s, "y"s, "z"s, "b"s, "c"s, "d"s, "e"s}));
+    v.Insert(v.end() - 1, begin(source), end(source));
+    assert((v == SimpleVector<string>{"a"s, "x"s, "y"s, "z"s, "b"s, "c"s, "d"s, "x"s, "y"s, "z"s, "e"s}));
+    assert(v.GetCapacity() == 20);
+  }
+
+  // Перевыделение памяти происходит один раз
+  {
+    SimpleVector<int> v{1, 2};
+    const int values[] = {3, 4, 5, 6, 7};
+    v.Insert(v.begin() + 1, begin(values), end(values));
+    assert(v.GetCapacity() == 7);
+    assert((v == SimpleVector<int>{1, 3, 4, 5, 6, 7, 2}));
+  }
+
+  // Вставка нескольких копий значения, в том числе элемента самого вектора
+  {
+    SimpleVector<string> v{"a"s, "b"s, "c"s};
+    v.Reserve(10);
+    v.Insert(v.begin(), 2, v[2]);
+    assert((v == SimpleVector<string>{"c"s, "c"s, "a"s, "b"s, "c"s}));
+    v.Insert(v.begin() + 4, 3, v[3]);
+    assert((v == SimpleVector<string>{"c"s, "c"s, "a"s, "b"s, "b"s, "b"s, "b"s, "c"s}));
+    v.Insert(v.begin() + 1, 5, "q"s);
+    assert(v.GetSize() == 13 && v[1] == "q"s && v[5] == "q"s && v[6] == "c"s);
+    SimpleVector<int> numbers;
+    numbers.Insert(numbers.begin(), 3, 7);
+    assert((numbers == SimpleVector<int>{7, 7, 7}));
+  }
+
+  // Итераторы ввода
+  {
+    istringstream input("4 5 6"s);
+    SimpleVector<int> v{1, 2, 3};
+    v.Insert(v.begin() + 1, istream_iterator<int>(input), istream_iterator<int>());
+    assert((v == SimpleVector<int>{1, 4, 5, 6, 2, 3}));
+  }
+
+  {
+    SimpleVector<int> v;
+    const int values[] = {1, 2, 3};
+    v.Append(begin(values), end(values));
+    v.Append(begin(values), begin(values) + 1);
+    assert((v == SimpleVector<int>{1, 2, 3, 1}));
+  }
+
+  // Присваивание диапазона повторно использует вместимость
+  {
+    SimpleVector<string> v{"a"s, "b"s, "c"s, "d"s};
+    auto *old_begin = v.Data();
+    v.Assign(begin(source), end(source));
+    assert((v == SimpleVector<string>{"x"s, "y"s, "z"s}));
+    v.Assign(begin(source), begin(source) + 1);
+    v.Assign(begin(source), end(source));
+    assert((v == SimpleVector<string>{"x"s, "y"s, "z"s}));
+    assert(v.Data() == old_begin);
+    const string longer[] = {"1"s, "2"s, "3"s, "4"s, "5"s};
+    v.Assign(begin(longer), end(longer));
+    assert(v.GetCapacity() == 5);
+    assert(v[4] == "5"s);
+    istringstream input("7 8"s);
+    SimpleVector<int> numbers{1, 2, 3};
+    numbers.Assign(istream_iterator<int>(input), istream_iterator<int>());
+    assert((numbers == SimpleVector<int>{7, 8}));
+  }
   cout << "Done!"s << endl << endl;
 }
 
 void TestReserveConstructor() {
   cout << "Test reserve constructor"s << endl;
   SimpleVector<int> v(Reserve(5));
-  assert(&v[0] != nullptr);
+  assert(v.Data() != nullptr);
   assert(v.GetCapacity() == 5);
   assert(v.IsEmpty());
   cout << "Done!"s << endl << endl;
@@ -341,6 +777,2088 @@ void TestReserveMethod() {
   cout << "Done!"s << endl << endl;
 }
 
+void TestRawStorage() {
+  cout << "Test raw storage"s << endl;
+  // Резервирование не создаёт объекты
+  {
+    Counted::ResetCounters();
+    SimpleVector<Counted> v;
+    v.Reserve(100);
+    assert(Counted::constructed == 0);
+    v.PushBack(Counted());
+    assert(Counted::constructed == 2);
+    assert(Counted::destroyed == 1);
+  }
+  assert(Counted::constructed == Counted::destroyed);
+
+  // Clear, PopBack и Resize разрушают удаляемые элементы
+  {
+    Counted::ResetCounters();
+    SimpleVector<Counted> v(10);
+    assert(Counted::constructed == 10);
+    v.PopBack();
+    assert(Counted::destroyed == 1);
+    v.Resize(4);
+    assert(Counted::destroyed == 6);
+    v.Clear();
+    assert(Counted::destroyed == 10);
+    assert(v.GetCapacity() == 10);
+  }
+
+  // Рост вместимости не создаёт лишних объектов
+  {
+    Counted::ResetCounters();
+    SimpleVector<Counted> v(2);
+    v.Resize(3);
+    assert(v.GetCapacity() == 4);
+    assert(Counted::constructed - Counted::destroyed == 3);
+  }
+  assert(Counted::constructed == Counted::destroyed);
+
+  // Тип без конструктора по умолчанию
+  {
+    SimpleVector<NoDefault> v;
+    for (int i = 0; i < 5; ++i) {
+      v.PushBack(NoDefault(i));
+    }
+    v.Insert(v.begin(), NoDefault(42));
+    v.Erase(v.begin() + 1);
+    auto copy(v);
+    assert(copy.GetSize() == 5);
+    assert(copy[0].GetValue() == 42);
+    assert(copy[4].GetValue() == 4);
+  }
+
+  // Вставка элемента самого вектора при перевыделении памяти
+  {
+    SimpleVector<string> v{"a"s, "b"s};
+    v.PushBack(v[0]);
+    v.Insert(v.begin(), v[2]);
+    assert((v == SimpleVector<string>{"a"s, "a"s, "b"s, "a"s}));
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestEmplace() {
+  cout << "Test emplace"s << endl;
+  // Элемент создаётся одним вызовом конструктора
+  {
+    Counted::ResetCounters();
+    SimpleVector<Counted> v(Reserve(3));
+    v.EmplaceBack();
+    assert(Counted::constructed == 1);
+    v.Emplace(v.end());
+    assert(Counted::constructed == 2);
+    assert(Counted::destroyed == 0);
+  }
+
+  // При перевыделении памяти элемент создаётся сразу в новом месте
+  {
+    Counted::ResetCounters();
+    SimpleVector<Counted> v(2);
+    v.Emplace(v.begin() + 1);
+    // 2 исходных элемента, 1 новый и 2 перенесённых
+    assert(Counted::constructed == 5);
+    assert(Counted::destroyed == 2);
+  }
+
+  {
+    SimpleVector<X> v;
+    X &back = v.EmplaceBack(3u);
+    assert(back.GetX() == 3);
+    assert(&back == &v[0]);
+    v.EmplaceBack(4u);
+    auto it = v.Emplace(v.begin() + 1, 10u);
+    assert(it == v.begin() + 1);
+    assert(v[0].GetX() == 3 && v[1].GetX() == 10 && v[2].GetX() == 4);
+    v.Emplace(v.begin() + 1, 11u);
+    assert(v[1].GetX() == 11 && v[2].GetX() == 10 && v[3].GetX() == 4);
+  }
+
+  // Аргументы могут ссылаться на элементы самого вектора
+  {
+    SimpleVector<string> v{"ab"s, "cd"s};
+    v.Reserve(4);
+    v.Emplace(v.begin(), v[1]);
+    v.EmplaceBack(v[0], 1u);
+    assert((v == SimpleVector<string>{"cd"s, "ab"s, "cd"s, "d"s}));
+    v.EmplaceBack(3u, 'x');
+    assert(v[4] == "xxx"s);
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestTriviallyCopyable() {
+  cout << "Test trivially copyable elements"s << endl;
+  struct Point {
+    int x;
+    double y;
+  };
+  static_assert(detail::kCanCopyBitwise<allocator<Point>, Point>);
+  static_assert(!detail::kCanCopyBitwise<allocator<string>, string>);
+  static_assert(detail::kCanCopyBitwise<pmr::polymorphic_allocator<int>, int>);
+  static_assert(!detail::kCanCopyBitwise<pmr::polymorphic_allocator<pmr::string>, pmr::string>);
+
+  SimpleVector<Point> v;
+  for (int i = 0; i < 100; ++i) {
+    v.PushBack({i, i * 0.5});
+  }
+  v.Insert(v.begin(), {-1, -0.5});
+  v.Erase(v.begin() + 50);
+  auto copy(v);
+  copy.Reserve(1000);
+  assert(copy.GetSize() == 100);
+  assert(copy[0].x == -1 && copy[1].x == 0);
+  assert(copy[49].x == 48 && copy[50].x == 50);
+  assert(copy[99].x == 99 && copy[99].y == 49.5);
+  cout << "Done!"s << endl << endl;
+}
+
+void TestStrongExceptionGuarantee() {
+  cout << "Test strong exception guarantee"s << endl;
+  auto make_vector = [] {
+    ThrowingCopy::copies_left = 100;
+    SimpleVector<ThrowingCopy> v;
+    v.Reserve(4);
+    for (int i = 0; i < 4; ++i) {
+      v.EmplaceBack(i);
+    }
+    return v;
+  };
+  auto is_intact = [](const SimpleVector<ThrowingCopy> &v) {
+    for (int i = 0; i < 4; ++i) {
+      if (v[i].GetValue() != i) {
+        return false;
+      }
+    }
+    return v.GetSize() == 4 && v.GetCapacity() == 4;
+  };
+
+  // Перемещение может бросить исключение, поэтому при перевыделении элементы копируются
+  {
+    auto v = make_vector();
+    ThrowingCopy::copies_left = 2;
+    try {
+      v.Reserve(10);
+      assert(false);
+    } catch (const runtime_error &) {
+    }
+    assert(is_intact(v));
+  }
+
+  {
+    auto v = make_vector();
+    ThrowingCopy::copies_left = 3;
+    try {
+      v.EmplaceBack(42);
+      assert(false);
+    } catch (const runtime_error &) {
+    }
+    assert(is_intact(v));
+
+    ThrowingCopy::copies_left = 1;
+    try {
+      v.Emplace(v.begin() + 2, 42);
+      assert(false);
+    } catch (const runtime_error &) {
+    }
+    assert(is_intact(v));
+
+    ThrowingCopy::copies_left = 4;
+    v.PushBack(ThrowingCopy(4));
+    assert(v.GetSize() == 5 && v[0].GetValue() == 0 && v[4].GetValue() == 4);
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestGrowthPolicy() {
+  cout << "Test growth policy"s << endl;
+  auto capacities = [](auto v) {
+    SimpleVector<size_t> result;
+    for (int i = 0; i < 20; ++i) {
+      if (v.GetSize() == v.GetCapacity()) {
+        // Вместимость после добавления элемента известна заранее
+        const size_t expected = v.GetGrowthCapacity(v.GetSize() + 1);
+        v.PushBack(i);
+        assert(v.GetCapacity() == expected);
+        result.PushBack(v.GetCapacity());
+      } else {
+        assert(v.GetGrowthCapacity(v.GetSize() + 1) == v.GetCapacity());
+        v.PushBack(i);
+      }
+    }
+    return result;
+  };
+
+  assert((capacities(SimpleVector<int>()) == SimpleVector<size_t>{1, 2, 4, 8, 16, 32}));
+  assert((capacities(SimpleVector<int, allocator<int>, OneAndHalfGrowth>())
+      == SimpleVector<size_t>{1, 2, 3, 4, 6, 9, 13, 19, 28}));
+  {
+    SimpleVector<int, allocator<int>, PowerOfTwoGrowth> v;
+    v.Resize(5);
+    assert(v.GetCapacity() == 8);
+    v.Resize(9);
+    assert(v.GetCapacity() == 16);
+  }
+  {
+    SimpleVector<int, allocator<int>, PageRoundedGrowth<>> v;
+    v.PushBack(1);
+    assert(v.GetCapacity() == 4096 / sizeof(int));
+    v.Resize(1025);
+    assert(v.GetCapacity() == 2 * 4096 / sizeof(int));
+  }
+  {
+    SimpleVector<char, allocator<char>, HugePageGrowth<>> v;
+    v.PushBack('a');
+    assert(v.GetCapacity() == (2u << 20));
+  }
+  // Вместимость не переполняется
+  assert(DoublingGrowth::NextCapacity(numeric_limits<size_t>::max() / 8 - 1, 1, 8)
+             == numeric_limits<size_t>::max() / 8);
+  cout << "Done!"s << endl << endl;
+}
+
+void TestAllocator() {
+  cout << "Test allocator"s << endl;
+  // Память выделяется переданным аллокатором
+  {
+    size_t allocations = 0;
+    using Alloc = TrackingAllocator<int>;
+    SimpleVector<int, Alloc> v(Alloc(1, &allocations));
+    v.Reserve(10);
+    assert(allocations == 1);
+    for (int i = 0; i < 11; ++i) {
+      v.PushBack(i);
+    }
+    assert(allocations == 2);
+    assert(v.GetAllocator().GetId() == 1);
+
+    // propagate_on_container_move_assignment и propagate_on_container_swap
+    SimpleVector<int, Alloc> other(Alloc(2, &allocations));
+    other = move(v);
+    assert(other.GetAllocator().GetId() == 1);
+    assert(other.GetSize() == 11);
+    assert(allocations == 2);
+
+    SimpleVector<int, Alloc> third(3, 7, Alloc(3, &allocations));
+    third.swap(other);
+    assert(third.GetAllocator().GetId() == 1);
+    assert(other.GetAllocator().GetId() == 3);
+    assert(third.GetSize() == 11 && other.GetSize() == 3);
+  }
+
+  // Копирующее присваивание использует существующую вместимость
+  {
+    size_t allocations = 0;
+    using Alloc = TrackingAllocator<int>;
+    SimpleVector<int, Alloc> src({1, 2, 3, 4}, Alloc(1, &allocations));
+    SimpleVector<int, Alloc> dst(Alloc(2, &allocations));
+    dst.Reserve(8);
+    allocations = 0;
+    const int *old_data = dst.Data();
+    for (int i = 0; i < 3; ++i) {
+      dst = src;
+      assert(dst == src);
+      src.PopBack();
+    }
+    assert(allocations == 0);
+    assert(dst.Data() == old_data && dst.GetCapacity() == 8);
+    assert(dst.GetAllocator().GetId() == 2);
+    dst = SimpleVector<int, Alloc>(10, 5, Alloc(1, &allocations));
+    src = SimpleVector<int, Alloc>(9, 1, Alloc(1, &allocations));
+    allocations = 0;
+    dst = src;
+    assert(allocations == 0 && dst.GetSize() == 9 && dst.GetCapacity() == 10);
+    src.Resize(11);
+    allocations = 0;
+    dst = src;
+    assert(allocations == 1 && dst == src);
+
+    Counted::ResetCounters();
+    {
+      SimpleVector<Counted> a(5);
+      SimpleVector<Counted> b(2);
+      a = b;
+      assert(a.GetSize() == 2 && a.GetCapacity() == 5);
+      b.Resize(4);
+      a = b;
+      assert(a.GetSize() == 4 && a.GetCapacity() == 5);
+    }
+    assert(Counted::constructed == Counted::destroyed);
+  }
+
+  // propagate_on_container_copy_assignment: память, выделенная старым аллокатором,
+  // освобождается им же, новая выделяется аллокатором rhs
+  {
+    size_t first_allocations = 0;
+    size_t second_allocations = 0;
+    using Alloc = CopyPropagatingAllocator<int>;
+    SimpleVector<int, Alloc> src({1, 2, 3}, Alloc(1, &first_allocations));
+    SimpleVector<int, Alloc> dst(8, 0, Alloc(2, &second_allocations));
+    first_allocations = 0;
+    dst = src;
+    assert(dst.GetAllocator().GetId() == 1);
+    assert(first_allocations == 1 && second_allocations == 1);
+    assert(dst == src);
+    // Аллокаторы теперь равны, и память снова не выделяется
+    src.PushBack(4);
+    first_allocations = 0;
+    dst.Reserve(4);
+    dst = src;
+    assert(first_allocations == 1 && dst == src);
+    src.PopBack();
+    dst = src;
+    assert(first_allocations == 1 && dst == src);
+    // Равный аллокатор тоже копируется, вместе с состоянием, которое не сравнивается
+    size_t third_allocations = 0;
+    const SimpleVector<int, Alloc> same_id({5, 6}, Alloc(1, &third_allocations));
+    dst = same_id;
+    third_allocations = 0;
+    dst.Reserve(100);
+    assert(third_allocations == 1 && first_allocations == 1 && dst == same_id);
+
+    SmallVector<int, 2, Alloc> small_src({1, 2, 3}, Alloc(1, &first_allocations));
+    SmallVector<int, 2, Alloc> small_dst({4, 5, 6, 7}, Alloc(2, &second_allocations));
+    small_dst = small_src;
+    assert(small_dst.GetAllocator().GetId() == 1 && small_dst == small_src);
+  }
+  {
+    size_t first_allocations = 0;
+    size_t second_allocations = 0;
+    using Alloc = CopyPropagatingAllocator<byte>;
+    BasicSoAVector<Alloc, DoublingGrowth, int, double> src(3, Alloc(1, &first_allocations));
+    BasicSoAVector<Alloc, DoublingGrowth, int, double> dst(5, Alloc(2, &second_allocations));
+    src.Get<0>(2) = 7;
+    first_allocations = second_allocations = 0;
+    dst = src;
+    assert(dst.GetAllocator().GetId() == 1 && dst == src);
+    assert(first_allocations == 2 && second_allocations == 0);
+  }
+
+  // std::pmr::polymorphic_allocator не передаётся при присваивании
+  {
+    using PmrVector = SimpleVector<pmr::string, pmr::polymorphic_allocator<pmr::string>>;
+    pmr::monotonic_buffer_resource resource;
+    PmrVector v(&resource);
+    v.PushBack(pmr::string("a long string that does not fit into SSO"));
+    v.Insert(v.begin(), pmr::string("another long string that does not fit into SSO"));
+    assert(v.GetAllocator().resource() == &resource);
+    // Элементы создаются через аллокатор вектора
+    assert(v[0].get_allocator().resource() == &resource);
+    assert(v[1].get_allocator().resource() == &resource);
+
+    // Копия по умолчанию использует ресурс по умолчанию
+    PmrVector copy(v);
+    assert(copy.GetAllocator().resource() == pmr::get_default_resource());
+    assert(copy == v);
+
+    // Аллокаторы не равны: элементы перемещаются по одному, аллокатор остаётся своим
+    PmrVector moved(&resource);
+    moved = move(copy);
+    assert(moved.GetAllocator().resource() == &resource);
+    assert(moved[0].get_allocator().resource() == &resource);
+    assert(moved == v);
+    assert(copy.IsEmpty());
+
+    // Аллокаторы равны: память забирается целиком
+    const auto *old_begin = v.Data();
+    PmrVector stolen(&resource);
+    stolen = move(v);
+    assert(stolen.Data() == old_begin);
+    assert(v.IsEmpty());
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestInstrumentation() {
+  cout << "Test instrumentation"s << endl;
+  // Без инструментирования вектор не становится больше
+#ifndef SIMPLE_VECTOR_CHECKED_ITERATORS
+  static_assert(sizeof(SimpleVector<int>) == 3 * sizeof(void *));
+#endif
+
+  using CountedVector = SimpleVector<int, allocator<int>, DoublingGrowth, CountingInstrumentation>;
+  CountingInstrumentation::ResetGlobalCounters();
+  {
+    CountedVector v;
+    for (int i = 1; i <= 5; ++i) {
+      v.PushBack(i);
+    }
+    // Вместимость 1, 2, 4, 8: четыре выделения и 0 + 1 + 2 + 4 перемещённых элемента
+    const auto &counters = v.GetInstrumentation().GetCounters();
+    assert(counters.allocations == 4);
+    assert(counters.bytes_allocated == (1 + 2 + 4 + 8) * sizeof(int));
+    assert(counters.elements_moved == 7);
+    assert(counters.elements_copied == 0);
+    assert(counters.peak_capacity == 8);
+
+    // Вставка и удаление в начале сдвигают весь хвост
+    v.Insert(v.begin(), 0);
+    assert(counters.elements_moved == 12);
+    v.Erase(v.begin());
+    assert(counters.elements_moved == 17);
+    assert(counters.allocations == 4);
+
+    CountedVector copy(v);
+    assert(copy.GetInstrumentation().GetCounters().allocations == 1);
+    assert(copy.GetInstrumentation().GetCounters().elements_copied == 5);
+
+    ostringstream out;
+    DumpInstrumentation(out, v);
+    assert(out.str() == "allocations=4 bytes_allocated=60 elements_moved=17 elements_copied=0"
+                        " peak_capacity=8 size=5 capacity=8 wasted_capacity=3"s);
+
+    const auto global = CountingInstrumentation::GetGlobalCounters();
+    assert(global.allocations == 5);
+    assert(global.elements_moved == 17);
+    assert(global.elements_copied == 5);
+    assert(global.peak_capacity == 8);
+  }
+  {
+    // Элементы, перемещение которых может бросить исключение, при перевыделении копируются
+    struct MayThrowMove {
+      MayThrowMove() = default;
+      MayThrowMove(const MayThrowMove &) = default;
+      MayThrowMove(MayThrowMove &&) noexcept(false) {
+      }
+    };
+    SimpleVector<MayThrowMove, allocator<MayThrowMove>, DoublingGrowth, CountingInstrumentation> v(2);
+    v.PushBack(MayThrowMove());
+    assert(v.GetInstrumentation().GetCounters().elements_copied == 2);
+    assert(v.GetInstrumentation().GetCounters().elements_moved == 0);
+  }
+  {
+    // Политика с необязательными событиями трассировки получает их вместе с обычными
+    struct RecordingInstrumentation : NoInstrumentation {
+      void OnReallocateBegin(size_t old_capacity, size_t new_capacity) noexcept {
+        log += "begin("s + to_string(old_capacity) + ","s + to_string(new_capacity) + ")"s;
+      }
+      void OnReallocateEnd(size_t old_capacity, size_t new_capacity, size_t bytes_moved) noexcept {
+        log += "end("s + to_string(old_capacity) + ","s + to_string(new_capacity) + ","s
+            + to_string(bytes_moved) + ")"s;
+      }
+      void OnShift(size_t bytes) noexcept {
+        log += "shift("s + to_string(bytes) + ")"s;
+      }
+      string log;
+    };
+    SimpleVector<int, allocator<int>, DoublingGrowth, RecordingInstrumentation> v{1, 2, 3};
+    const string &log = v.GetInstrumentation().log;
+    v.PushBack(4);
+    assert(log == "begin(3,6)end(3,6,12)"s);
+    v.Insert(v.begin(), 0);
+    v.Erase(v.begin() + 1, v.begin() + 3);
+    assert(log == "begin(3,6)end(3,6,12)shift(16)shift(8)"s);
+    v.Reserve(10);
+    v.Resize(12);
+    v.ShrinkToFit();
+    assert(log == "begin(3,6)end(3,6,12)shift(16)shift(8)begin(6,10)end(6,10,12)"
+                  "begin(10,20)end(10,20,12)begin(20,12)end(20,12,48)"s);
+    // Вставка в конец и заполнение без перевыделения ничего не сдвигают
+    const string before = log;
+    const int values[] = {1, 2};
+    v.Assign(begin(values), end(values));
+    v.PopBack();
+    v.PushBack(2);
+    assert(log == before);
+  }
+  {
+    using TracedVector = SimpleVector<int, allocator<int>, DoublingGrowth, TracingInstrumentation>;
+    vector<TraceEvent> events;
+    TracingInstrumentation::SetHandler([](const TraceEvent &event, void *context) {
+      static_cast<vector<TraceEvent> *>(context)->push_back(event);
+    }, &events);
+    TracingInstrumentation::SetShiftThreshold(8 * sizeof(int));
+    TracedVector v(8);
+    v.Insert(v.begin() + 4, 1);
+    assert(events.size() == 1);
+    assert(events[0].kind == TraceEvent::Kind::kReallocation);
+    assert(events[0].old_capacity == 8 && events[0].new_capacity == 16);
+    assert(events[0].bytes == 8 * sizeof(int));
+    assert(events[0].duration.count() >= 0);
+
+    // Сдвиг 4 элементов меньше порога, сдвиг 8 элементов - нет
+    v.Erase(v.begin() + 4);
+    assert(events.size() == 1);
+    v.Insert(v.begin(), 1);
+    assert(events.size() == 2);
+    assert(events[1].kind == TraceEvent::Kind::kShift);
+    assert(events[1].bytes == 8 * sizeof(int));
+
+    TracingInstrumentation::SetHandler(nullptr);
+    TracingInstrumentation::SetShiftThreshold(TracingInstrumentation::kDefaultShiftThreshold);
+    v.Reserve(100);
+    v.Insert(v.begin(), 1);
+    assert(events.size() == 2);
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestParallelAlgorithms() {
+  cout << "Test parallel algorithms"s << endl;
+  ThreadPool pool(4);
+  ParallelOptions options;
+  options.pool = &pool;
+  options.min_chunk_size = 100;
+  const size_t size = 100000;
+
+  {
+    SimpleVector<int> v(size);
+    ParallelFill(v, 2, options);
+    assert(all_of(v.begin(), v.end(), [](int x) {
+      return x == 2;
+    }));
+    ParallelForEach(v, [](int &x) {
+      ++x;
+    }, options);
+    assert(all_of(v.begin(), v.end(), [](int x) {
+      return x == 3;
+    }));
+    // Диапазон, начало которого не совпадает с началом кэш-линии
+    ParallelFill(v.Data() + 1, v.Data() + v.GetSize() - 1, 0, options);
+    assert(v[0] == 3 && v[1] == 0 && v[size - 2] == 0 && v[size - 1] == 3);
+    ParallelFill(v.Data(), v.Data(), 1, options);
+    assert(v[0] == 3);
+  }
+  {
+    // Внутренние границы частей попадают на начало кэш-линий
+    SimpleVector<int> v(size);
+    const auto boundaries = detail::SplitIntoChunks(v.Data() + 3, v.Data() + v.GetSize(), options);
+    assert(boundaries.size() > 2);
+    assert(boundaries.front() == v.Data() + 3 && boundaries.back() == v.Data() + v.GetSize());
+    for (size_t i = 1; i + 1 < boundaries.size(); ++i) {
+      assert(reinterpret_cast<uintptr_t>(boundaries[i]) % detail::kCacheLineSize == 0);
+      assert(boundaries[i] > boundaries[i - 1]);
+    }
+  }
+  {
+    SimpleVector<int> v(size);
+    iota(v.begin(), v.end(), 0);
+    SimpleVector<long long> squares(size);
+    auto end = ParallelTransform(v.Data(), v.Data() + v.GetSize(), squares.Data(), [](int x) {
+      return static_cast<long long>(x) * x;
+    }, options);
+    assert(end == squares.Data() + squares.GetSize());
+    assert(squares[0] == 0 && squares[size - 1] == static_cast<long long>(size - 1) * (size - 1));
+
+    assert(ParallelReduce(v, 0LL, plus<>(), options) == static_cast<long long>(size) * (size - 1) / 2);
+    assert(ParallelReduce(v.Data(), v.Data(), 7, plus<>(), options) == 7);
+    // Результаты частей сворачиваются по порядку, поэтому неперестановочная операция допустима
+    SimpleVector<string> words(1000, "a"s);
+    const auto joined = ParallelReduce(words, ""s, plus<>(), options);
+    assert(joined == string(1000, 'a'));
+  }
+  {
+    SimpleVector<int> v(size);
+    for (size_t i = 0; i < size; ++i) {
+      v[i] = static_cast<int>((i * 7919) % 1000);
+    }
+    SimpleVector<int> expected(v);
+    sort(expected.begin(), expected.end());
+    ParallelSort(v, less<>(), options);
+    assert(v == expected);
+    ParallelSort(v.Data(), v.Data() + v.GetSize(), greater<>(), options);
+    assert(is_sorted(v.begin(), v.end(), greater<>()));
+  }
+  {
+    // Исключение из части передаётся вызывающему потоку
+    SimpleVector<int> v(size);
+    bool thrown = false;
+    try {
+      ParallelForEach(v.Data(), v.Data() + v.GetSize(), [](int &x) {
+        if (x == 0) {
+          throw runtime_error("chunk failed"s);
+        }
+      }, options);
+    } catch (const runtime_error &) {
+      thrown = true;
+    }
+    assert(thrown);
+  }
+  {
+    // Вложенный ParallelFor из задачи пула не блокируется
+    atomic<size_t> total = 0;
+    ParallelFor(pool, 8, 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        ParallelFor(pool, 100, 10, [&](size_t inner_begin, size_t inner_end) {
+          total += inner_end - inner_begin;
+        });
+      }
+    });
+    assert(total == 800);
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestParallelInit() {
+  cout << "Test parallel init"s << endl;
+  ThreadPool pool(4);
+  ParallelOptions options;
+  options.pool = &pool;
+  options.min_chunk_size = 100;
+  const size_t size = 100000;
+  {
+    SimpleVector<int> v(ParallelInit(options), size);
+    assert(v.GetSize() == size && v.GetCapacity() == size);
+    assert(all_of(v.begin(), v.end(), [](int x) {
+      return x == 0;
+    }));
+
+    SimpleVector<string> words(ParallelInit(options), size, "word"s);
+    assert(words.GetSize() == size);
+    assert(all_of(words.begin(), words.end(), [](const string &word) {
+      return word == "word"s;
+    }));
+
+    iota(v.begin(), v.end(), 0);
+    SimpleVector<int> copy(ParallelInit(options), v);
+    assert(copy == v);
+    assert(copy.Data() != v.Data());
+
+    SimpleVector<int> empty(ParallelInit(options), SimpleVector<int>());
+    assert(empty.IsEmpty());
+  }
+  {
+    // Если создание одной части прервалось исключением, созданные элементы остальных разрушаются
+    ThrowingDefault::constructions_left = size / 2;
+    bool thrown = false;
+    try {
+      SimpleVector<ThrowingDefault> v(ParallelInit(options), size);
+    } catch (const runtime_error &) {
+      thrown = true;
+    }
+    assert(thrown);
+    assert(ThrowingDefault::alive == 0);
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestAlignedStorage() {
+  cout << "Test aligned storage"s << endl;
+  {
+    AlignedSimpleVector<float> v;
+    for (int i = 0; i < 1000; ++i) {
+      v.PushBack(static_cast<float>(i));
+      assert(reinterpret_cast<uintptr_t>(v.Data()) % 64 == 0);
+    }
+    assert(v.AlignedData() == v.Data());
+    v.ShrinkToFit();
+    assert(reinterpret_cast<uintptr_t>(v.Data()) % 64 == 0);
+
+    const auto &cv = v;
+    float sum = 0;
+    const float *data = cv.AlignedData();
+    for (size_t i = 0; i < cv.GetSize(); ++i) {
+      sum += data[i];
+    }
+    assert(sum == 999.0f * 1000.0f / 2.0f);
+
+    AlignedSimpleVector<float> copy(v);
+    assert(copy == v);
+    assert(reinterpret_cast<uintptr_t>(copy.Data()) % 64 == 0);
+  }
+  {
+    AlignedSimpleVector<double, 4096> v(3, 1.5);
+    assert(reinterpret_cast<uintptr_t>(v.Data()) % 4096 == 0);
+    static_assert(detail::kAllocatorAlignment<decltype(v.GetAllocator())> == 4096);
+  }
+  // Аллокатор без гарантий выравнивания даёт выравнивание типа
+  static_assert(detail::kAllocatorAlignment<allocator<double>> == alignof(double));
+  static_assert(is_same_v<allocator_traits<AlignedAllocator<int, 32>>::rebind_alloc<char>, AlignedAllocator<char, 32>>);
+  cout << "Done!"s << endl << endl;
+}
+
+void TestMappedVector() {
+  cout << "Test mapped vector"s << endl;
+  const string path = (filesystem::temp_directory_path() / "simple_vector_test_mapped.bin").string();
+  {
+    MappedVector<int> v(path, MappedFileMode::kTruncate);
+    assert(v.IsEmpty());
+    assert(v.GetCapacity() > 0);
+    for (int i = 0; i < 10000; ++i) {
+      v.PushBack(i);
+    }
+    // Элемент из самого файла переживает перемещение отображения
+    while (v.GetSize() != v.GetCapacity()) {
+      v.PushBack(0);
+    }
+    v.PushBack(v[1]);
+    assert(v[v.GetSize() - 1] == 1);
+    v.Resize(10000);
+    v.Insert(v.begin(), -1);
+    v.Erase(v.begin());
+    assert(v.GetSize() == 10000 && v[0] == 0 && v[9999] == 9999);
+    assert(reinterpret_cast<uintptr_t>(v.begin()) % 64 == 0);
+    v.Flush();
+    v.Sync();
+  }
+  {
+    // Данные и размер сохраняются в файле
+    MappedVector<int> v(path);
+    assert(v.GetSize() == 10000);
+    for (int i = 0; i < 10000; ++i) {
+      assert(v[i] == i);
+    }
+    const size_t capacity = v.GetCapacity();
+    v.Resize(100);
+    v.ShrinkToFit();
+    assert(v.GetCapacity() < capacity && v.GetCapacity() >= 100);
+    assert(filesystem::file_size(path) == sizeof(detail::FileHeader) + v.GetCapacity() * sizeof(int));
+    v.Resize(200);
+    assert(v[99] == 99 && v[100] == 0 && v[199] == 0);
+
+    MappedVector<int> moved(move(v));
+    assert(moved.GetSize() == 200 && v.GetSize() == 0);
+    try {
+      moved.At(200);
+      assert(false);
+    } catch (const out_of_range &) {
+    }
+  }
+  {
+    // Рост в пределах вместимости не увеличивает файл
+    MappedVector<int> v(path, MappedFileMode::kTruncate);
+    v.Reserve(1000);
+    const size_t capacity = v.GetCapacity();
+    const auto file_size = filesystem::file_size(path);
+    v.Resize(10);
+    v.Resize(20);
+    v.ResizeUninitialized(30);
+    v.Resize(capacity);
+    assert(v.GetCapacity() == capacity);
+    assert(filesystem::file_size(path) == file_size);
+    v.Resize(capacity + 1);
+    assert(v.GetCapacity() > capacity);
+  }
+  {
+    // Файл с элементами другого размера не открывается
+    bool thrown = false;
+    try {
+      MappedVector<double> v(path);
+    } catch (const runtime_error &) {
+      thrown = true;
+    }
+    assert(thrown);
+  }
+  {
+    bool thrown = false;
+    try {
+      MappedVector<int> v((filesystem::temp_directory_path() / "no_such_dir" / "file.bin").string());
+    } catch (const system_error &) {
+      thrown = true;
+    }
+    assert(thrown);
+  }
+  filesystem::remove(path);
+  cout << "Done!"s << endl << endl;
+}
+
+void TestSerialization() {
+  cout << "Test serialization"s << endl;
+  struct Point {
+    double x;
+    double y;
+  };
+  {
+    SimpleVector<int> v(1000);
+    iota(v.begin(), v.end(), 0);
+    stringstream stream;
+    Serialize(stream, v);
+    assert(stream.str().size() == SerializedSize(v));
+    assert(SerializedSize(v) == sizeof(detail::FileHeader) + 1000 * sizeof(int));
+
+    // Память под элементы выделяется один раз, ровно под их число
+    SimpleVector<int, allocator<int>, DoublingGrowth, CountingInstrumentation> restored{1, 2, 3};
+    const size_t allocations = restored.GetInstrumentation().GetCounters().allocations;
+    Deserialize(stream, restored);
+    assert(restored.GetInstrumentation().GetCounters().allocations == allocations + 1);
+    assert(restored.GetSize() == 1000 && restored.GetCapacity() == 1000);
+    assert(equal(v.begin(), v.end(), restored.begin(), restored.end()));
+  }
+  {
+    SimpleVector<Point> points{{1.0, 2.0}, {3.0, 4.0}};
+    SimpleVector<unsigned char> buffer(SerializedSize(points));
+    assert(Serialize(buffer.Data(), buffer.GetSize(), points) == buffer.GetSize());
+
+    SmallVector<Point, 4> restored;
+    assert(Deserialize(buffer.Data(), buffer.GetSize(), restored) == buffer.GetSize());
+    assert(restored.GetSize() == 2 && restored[1].x == 3.0 && restored[1].y == 4.0);
+
+    // Пустой вектор
+    SimpleVector<Point> empty;
+    stringstream stream;
+    Serialize(stream, empty);
+    Deserialize(stream, points);
+    assert(points.IsEmpty());
+  }
+  {
+    SimpleVector<int> v{1, 2, 3};
+    SimpleVector<unsigned char> buffer(SerializedSize(v));
+    Serialize(buffer.Data(), buffer.GetSize(), v);
+
+    auto expect_error = [&](auto &&function) {
+      bool thrown = false;
+      try {
+        function();
+      } catch (const runtime_error &) {
+        thrown = true;
+      }
+      assert(thrown);
+    };
+    // Обрезанные данные
+    SimpleVector<int> restored;
+    expect_error([&] {
+      Deserialize(buffer.Data(), buffer.GetSize() - 1, restored);
+    });
+    expect_error([&] {
+      stringstream stream(string(buffer.begin(), buffer.end() - 1));
+      Deserialize(stream, restored);
+    });
+    // Размер в заголовке больше, чем данных в потоке: память не выделяется
+    SimpleVector<unsigned char> oversized(buffer);
+    const uint64_t huge_size = uint64_t(1) << 60;
+    memcpy(oversized.Data() + offsetof(detail::FileHeader, size), &huge_size, sizeof(huge_size));
+    SimpleVector<int, allocator<int>, DoublingGrowth, CountingInstrumentation> counted;
+    expect_error([&] {
+      stringstream stream(string(oversized.begin(), oversized.end()));
+      Deserialize(stream, counted);
+    });
+    assert(counted.GetInstrumentation().GetCounters().allocations == 0);
+    // Поток без позиционирования читается блоками и обрывается на конце данных
+    struct UnseekableBuffer : streambuf {
+      UnseekableBuffer(SimpleVector<unsigned char> &data) {
+        char *begin = reinterpret_cast<char *>(data.Data());
+        setg(begin, begin, begin + data.GetSize());
+      }
+    };
+    expect_error([&] {
+      UnseekableBuffer source(oversized);
+      istream stream(&source);
+      Deserialize(stream, counted);
+    });
+    assert(counted.GetInstrumentation().GetCounters().bytes_allocated <= 2 * detail::kReadChunkBytes);
+    {
+      UnseekableBuffer source(buffer);
+      istream stream(&source);
+      Deserialize(stream, restored);
+      assert(restored == v);
+    }
+    // Элементы другого размера
+    SimpleVector<int64_t> wrong_type;
+    expect_error([&] {
+      Deserialize(buffer.Data(), buffer.GetSize(), wrong_type);
+    });
+    // Другой порядок байтов
+    buffer[offsetof(detail::FileHeader, endianness)] ^= 0x03;
+    buffer[offsetof(detail::FileHeader, endianness) + 1] ^= 0x03;
+    expect_error([&] {
+      Deserialize(buffer.Data(), buffer.GetSize(), restored);
+    });
+    try {
+      Serialize(buffer.Data(), buffer.GetSize() - 1, v);
+      assert(false);
+    } catch (const length_error &) {
+    }
+  }
+  {
+    // Записанный файл открывается MappedVector без чтения, и наоборот
+    const string path = (filesystem::temp_directory_path() / "simple_vector_test_serialized.bin").string();
+    SimpleVector<int> v(5000);
+    iota(v.begin(), v.end(), 0);
+    {
+      ofstream out(path, ios::binary | ios::trunc);
+      Serialize(out, v);
+    }
+    {
+      MappedVector<int> mapped(path);
+      assert(mapped.GetSize() == 5000);
+      assert(equal(v.begin(), v.end(), mapped.begin(), mapped.end()));
+      mapped.PushBack(5000);
+    }
+    ifstream in(path, ios::binary);
+    SimpleVector<int> restored;
+    Deserialize(in, restored);
+    assert(restored.GetSize() == 5001 && restored[5000] == 5000);
+    in.close();
+
+    // В MappedVector файл растёт один раз, ровно под прочитанные элементы
+    const string copy_path = path + ".copy"s;
+    {
+      MappedVector<int> mapped(copy_path, MappedFileMode::kTruncate);
+      ifstream source(path, ios::binary);
+      Deserialize(source, mapped);
+      assert(mapped.GetSize() == 5001);
+      assert(mapped.GetCapacity() < 5001 + 4096 / sizeof(int));
+    }
+    filesystem::remove(copy_path);
+    filesystem::remove(path);
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestVectorIo() {
+  cout << "Test vector io"s << endl;
+  int fds[2];
+  assert(pipe(fds) == 0);
+  // Несколько буферов записываются и читаются одним системным вызовом
+  {
+    const SimpleVector<char> header{'h', 'd', 'r', ':'};
+    const string body = "payload"s;
+    const SmallVector<char, 4> trailer{'!', '\n'};
+    const size_t written = WriteVectored(fds[1], header, SimpleSpan<const char>(body.data(), body.size()), trailer);
+    assert(written == 13);
+
+    SimpleVector<char> first{'>'};
+    SmallVector<char, 2> second;
+    // Места для чтения больше, чем данных: размер растёт ровно на прочитанное
+    assert(ReadVectored(fds[0], ReadInto(first, 4), ReadInto(second, 100)) == 13);
+    assert(first.GetSize() == 5 && first.GetCapacity() >= 5);
+    assert(string(first.begin(), first.end()) == ">hdr:"s);
+    assert(string(second.begin(), second.end()) == "payload!\n"s);
+  }
+  // Байты неполного элемента остаются за концом вектора
+  {
+    const SimpleVector<uint16_t> numbers{1, 2, 3};
+    const SimpleVector<char> odd{'x'};
+    assert(WriteVectored(fds[1], numbers, odd) == 7);
+    SimpleVector<uint32_t> words;
+    assert(ReadVectored(fds[0], ReadInto(words, 10)) == 7);
+    assert(words.GetSize() == 1 && words.GetCapacity() >= 10);
+  }
+  // Чтение в MappedVector в пределах вместимости не увеличивает файл
+  {
+    const string path = (filesystem::temp_directory_path() / "simple_vector_test_readv.bin").string();
+    MappedVector<int> mapped(path, MappedFileMode::kTruncate);
+    mapped.Reserve(100);
+    const size_t capacity = mapped.GetCapacity();
+    const SimpleVector<int> numbers{1, 2, 3, 4};
+    for (int i = 0; i < 3; ++i) {
+      assert(WriteVectored(fds[1], numbers) == sizeof(int) * 4);
+      assert(ReadVectored(fds[0], ReadInto(mapped, 4)) == sizeof(int) * 4);
+    }
+    assert(mapped.GetSize() == 12 && mapped[11] == 4);
+    assert(mapped.GetCapacity() == capacity);
+    filesystem::remove(path);
+  }
+  // Пустой список для чтения и закрытый канал
+  {
+    assert(WriteVectored(fds[1], SimpleVector<char>()) == 0);
+    close(fds[1]);
+    SimpleVector<char> v;
+    assert(ReadVectored(fds[0], ReadInto(v, 16)) == 0 && v.IsEmpty());
+    close(fds[0]);
+    try {
+      ReadVectored(fds[0], ReadInto(v, 16));
+      assert(false);
+    } catch (const system_error &e) {
+      assert(e.code() == errc::bad_file_descriptor);
+    }
+    assert(v.IsEmpty());
+  }
+  // Операции io_uring: несколько операций передаются ядру одним вызовом Submit
+  try {
+    IoUringQueue queue(4);
+    assert(queue.GetCapacity() >= 4 && queue.GetInFlight() == 0);
+    const string path = (filesystem::temp_directory_path() / "simple_vector_test_uring.bin").string();
+    const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    assert(fd >= 0);
+
+    const SimpleVector<int> first{1, 2, 3};
+    const SimpleVector<int> second{4, 5};
+    queue.PrepareWrite(fd, first, 0, 1);
+    queue.PrepareWrite(fd, second, sizeof(int) * 3, 2);
+    assert(queue.Submit() == 2);
+    SimpleVector<uint64_t> completed;
+    for (int i = 0; i < 2; ++i) {
+      const IoCompletion completion = queue.WaitCompletion();
+      assert(completion.result == static_cast<int>((completion.user_data == 1 ? 3 : 2) * sizeof(int)));
+      completed.PushBack(completion.user_data);
+    }
+    sort(completed.begin(), completed.end());
+    assert((completed == SimpleVector<uint64_t>{1, 2}));
+
+    SimpleVector<int> restored{0};
+    SimpleVector<int> tail;
+    queue.PrepareRead(fd, ReadInto(restored, 3), 0, 3);
+    queue.PrepareRead(fd, ReadInto(tail, 10), sizeof(int) * 3, 4);
+    // Размер увеличивается только после завершения операции
+    assert(restored.GetSize() == 1 && restored.GetCapacity() >= 4);
+    for (int i = 0; i < 2; ++i) {
+      assert(queue.WaitCompletion().result > 0);
+    }
+    assert((restored == SimpleVector<int>{0, 1, 2, 3}));
+    assert((tail == SimpleVector<int>{4, 5}));
+
+    // Ошибка операции возвращается в завершении, а размер вектора не меняется
+    queue.PrepareRead(-1, ReadInto(tail, 1), 0, 5);
+    const IoCompletion failed = queue.WaitCompletion();
+    assert(failed.user_data == 5 && failed.result == -EBADF);
+    assert(tail.GetSize() == 2);
+
+    // Незавершённых операций не может быть больше вместимости очереди
+    SimpleVector<SimpleVector<int>> buffers(queue.GetCapacity() + 1);
+    for (size_t i = 0; i < queue.GetCapacity(); ++i) {
+      queue.PrepareRead(fd, ReadInto(buffers[i], 1), 0, i);
+    }
+    try {
+      queue.PrepareRead(fd, ReadInto(buffers[queue.GetCapacity()], 1), 0, 0);
+      assert(false);
+    } catch (const length_error &) {
+    }
+    while (queue.GetInFlight() != 0) {
+      assert(queue.WaitCompletion().result == static_cast<int>(sizeof(int)));
+    }
+    assert(buffers[0][0] == 1 && buffers[queue.GetCapacity() - 1][0] == 1 && buffers[queue.GetCapacity()].IsEmpty());
+    close(fd);
+    filesystem::remove(path);
+  } catch (const system_error &e) {
+    // io_uring может быть недоступен в ядре или запрещён политикой seccomp
+    cout << "io_uring is unavailable: "s << e.what() << endl;
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestSimpleSpan() {
+  cout << "Test simple span"s << endl;
+  SimpleVector<int> v(10);
+  iota(v.begin(), v.end(), 0);
+  {
+    SimpleSpan span(v);
+    static_assert(is_same_v<decltype(span), SimpleSpan<int>>);
+    assert(span.GetSize() == 10 && span.Data() == v.Data());
+    // Изменения через представление видны в векторе
+    span[0] = 100;
+    assert(v[0] == 100);
+    v[0] = 0;
+
+    auto first = span.First(3);
+    assert(first.GetSize() == 3 && first.begin() == v.Data() && first[2] == 2);
+    auto last = span.Last(2);
+    assert(last.GetSize() == 2 && last[0] == 8 && last.end() == v.Data() + v.GetSize());
+    auto middle = span.Subspan(4, 3);
+    assert(middle.GetSize() == 3 && middle[0] == 4 && middle[2] == 6);
+    auto tail = span.Subspan(7);
+    assert(tail.GetSize() == 3 && tail[0] == 7);
+    assert(span.Subspan(10).IsEmpty());
+    assert(span.First(0).IsEmpty() && span.Last(0).IsEmpty());
+    // Части частей указывают в тот же буфер
+    assert(middle.Subspan(1).First(1).Data() == v.Data() + 5);
+
+    try {
+      middle.At(3);
+      assert(false);
+    } catch (const out_of_range &) {
+    }
+  }
+  {
+    const SimpleVector<int> &cv = v;
+    SimpleSpan span(cv);
+    static_assert(is_same_v<decltype(span), SimpleSpan<const int>>);
+    SimpleSpan<const int> from_mutable = SimpleSpan<int>(v);
+    assert(span == from_mutable);
+    static_assert(!is_constructible_v<SimpleSpan<int>, const SimpleVector<int> &>);
+    static_assert(!is_constructible_v<SimpleSpan<int>, SimpleSpan<const int>>);
+    static_assert(!is_constructible_v<SimpleSpan<long>, SimpleVector<int> &>);
+
+    SimpleSpan range(v.Data() + 2, v.Data() + 5);
+    assert(range.GetSize() == 3 && range[0] == 2);
+    assert(accumulate(range.begin(), range.end(), 0) == 2 + 3 + 4);
+  }
+  {
+    SimpleVector<int> other{0, 1, 2, 9};
+    SimpleSpan<const int> a(v);
+    SimpleSpan<const int> b(other);
+    assert(a.First(3) == b.First(3));
+    assert(a != b);
+    assert(a < b && b > a && a <= b && b >= a);
+    assert(SimpleSpan<int>() == SimpleSpan<const int>());
+  }
+  {
+    // Представление части вектора записывается без копирования части
+    SimpleSpan<const int> part = SimpleSpan(v).Subspan(2, 4);
+    SimpleVector<unsigned char> buffer(SerializedSize(part));
+    Serialize(SimpleSpan(buffer), part);
+    SimpleVector<int> restored;
+    Deserialize(SimpleSpan<const unsigned char>(buffer), restored);
+    assert((restored == SimpleVector<int>{2, 3, 4, 5}));
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+#ifdef SIMPLE_VECTOR_HAS_CONSTEXPR
+// Вектор создаётся, изменяется и разрушается во время компиляции
+constexpr int ConstexprVectorSum() {
+  SimpleVector<int> v(Reserve(2));
+  for (int i = 1; i <= 5; ++i) {
+    v.PushBack(i);
+  }
+  v.Insert(v.begin(), 10);
+  v.Erase(v.begin() + 1);
+  v.Resize(7);
+  v.Resize(8, 1);
+  v.ResizeDefaultInit(9);
+  v.Resize(7);
+  v.Insert(v.end(), 2, 3);
+  SimpleVector<int> copy(v);
+  copy.PopBack();
+  copy.ShrinkToFit();
+  int sum = 0;
+  for (int x : copy) {
+    sum += x;
+  }
+  return sum;
+}
+
+constexpr bool ConstexprComparison() {
+  const SimpleVector<int> a{1, 2, 3};
+  SimpleVector<int> b = a;
+  if (!(a == b)) {
+    return false;
+  }
+  b[2] = 4;
+  return a != b && a < b && !(b < a) && SimpleVector<unsigned char>{1, 2} < SimpleVector<unsigned char>{1, 3};
+}
+
+// Таблица квадратов, построенная через SimpleVector в consteval-функции
+consteval std::array<int, 8> MakeSquaresTable() {
+  SimpleVector<int> squares;
+  for (int i = 0; i < 8; ++i) {
+    squares.EmplaceBack(i * i);
+  }
+  std::array<int, 8> table{};
+  for (size_t i = 0; i < squares.GetSize(); ++i) {
+    table[i] = squares[i];
+  }
+  return table;
+}
+
+void TestConstexpr() {
+  cout << "Test constexpr"s << endl;
+  static_assert(ConstexprVectorSum() == 10 + 2 + 3 + 4 + 5 + 0 + 0 + 3);
+  static_assert(ConstexprComparison());
+  constexpr auto table = MakeSquaresTable();
+  static_assert(table[0] == 0 && table[3] == 9 && table[7] == 49);
+  // Те же функции работают и во время выполнения
+  assert(ConstexprVectorSum() == 27);
+  assert(ConstexprComparison());
+  cout << "Done!"s << endl << endl;
+}
+#endif
+
+#ifdef SIMPLE_VECTOR_CHECKED_ITERATORS
+struct CheckFailure : logic_error {
+  using logic_error::logic_error;
+};
+
+void ThrowCheckFailure(const char *message) {
+  throw CheckFailure(message);
+}
+
+// Сообщает, обнаружила ли проверка итераторов нарушение в action
+template<typename Action>
+bool FailsCheck(Action action) {
+  try {
+    action();
+  } catch (const CheckFailure &) {
+    return true;
+  }
+  return false;
+}
+
+void TestCheckedIterators() {
+  cout << "Test checked iterators"s << endl;
+  const CheckFailureHandler old_handler = SetCheckFailureHandler(ThrowCheckFailure);
+  {
+    // Итераторы становятся недействительными после перевыделения памяти
+    SimpleVector<int> v{1, 2, 3};
+    auto it = v.begin() + 1;
+    assert(*it == 2);
+    v.Reserve(100);
+    assert(FailsCheck([&] {
+      return *it;
+    }));
+    it = v.begin();
+    v.Resize(200);
+    assert(FailsCheck([&] {
+      ++it;
+    }));
+    SimpleVector<int>::ConstIterator end = v.cend();
+    v.PushBack(4);
+    assert(FailsCheck([&] {
+      return end - v.cbegin();
+    }));
+  }
+  {
+    // Без перевыделения памяти итераторы остаются действительными
+    SimpleVector<int> v(Reserve(10));
+    v.PushBack(1);
+    auto it = v.begin();
+    v.PushBack(2);
+    v.Insert(v.begin() + 1, 3);
+    assert(*it == 1 && it[1] == 3);
+    SimpleVector<int>::ConstIterator const_it = it;
+    assert(const_it == v.cbegin() && v.end() - const_it == 3);
+  }
+  {
+    // Выход за границы вектора
+    SimpleVector<int> v{1, 2, 3};
+    assert(FailsCheck([&] {
+      return v[3];
+    }));
+    assert(FailsCheck([&] {
+      return *v.end();
+    }));
+    assert(FailsCheck([&] {
+      return v.end() + 1;
+    }));
+    assert(FailsCheck([&] {
+      return v.begin() - 1;
+    }));
+    assert(FailsCheck([&] {
+      v.Erase(v.end());
+    }));
+    assert(FailsCheck([&] {
+      v.Erase(v.end(), v.begin());
+    }));
+    assert(FailsCheck([&] {
+      v.UnorderedErase(v.end());
+    }));
+    SimpleVector<int> empty;
+    assert(FailsCheck([&] {
+      empty.PopBack();
+    }));
+    GapBuffer<int> gap{1, 2, 3};
+    assert(FailsCheck([&] {
+      gap.Erase(gap.end(), gap.begin());
+    }));
+    assert(gap.GetSize() == 3);
+  }
+  {
+    // Итераторы другого вектора
+    SimpleVector<int> a{1, 2};
+    SimpleVector<int> b{1, 2};
+    assert(FailsCheck([&] {
+      return a.begin() == b.begin();
+    }));
+    assert(FailsCheck([&] {
+      a.Insert(b.begin(), 0);
+    }));
+    assert(FailsCheck([&] {
+      a.Erase(a.begin(), b.end());
+    }));
+    assert(a.GetSize() == 2);
+  }
+  {
+    // Итератор, созданный по умолчанию, можно сдвинуть на 0, но не дальше
+    using It = SimpleVector<int>::Iterator;
+    assert(It{} + 0 == It{} && It{} - 0 == It{} && It{} - It{} == 0);
+    assert(FailsCheck([] {
+      It it;
+      it++;
+    }));
+    assert(FailsCheck([] {
+      return It{} - 1;
+    }));
+    assert(FailsCheck([] {
+      return *It{};
+    }));
+  }
+  SetCheckFailureHandler(old_handler);
+  cout << "Done!"s << endl << endl;
+}
+#endif
+
+// Ресурс памяти, считающий выделения из нескольких потоков
+struct CountingResource : pmr::memory_resource {
+  atomic<size_t> allocations = 0;
+
+ private:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    ++allocations;
+    return pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+    pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+void TestConcurrentSimpleVector() {
+  cout << "Test concurrent simple vector"s << endl;
+  {
+    // Потоки добавляют элементы одновременно; каждый элемент попадает ровно в одну ячейку
+    const int thread_count = 4;
+    const int per_thread = 20000;
+    ConcurrentSimpleVector<int> v;
+    SimpleVector<thread> producers;
+    for (int t = 0; t < thread_count; ++t) {
+      producers.PushBack(thread([&v, t] {
+        for (int i = 0; i < per_thread; ++i) {
+          const size_t index = v.PushBack(t * per_thread + i);
+          assert(v[index] == t * per_thread + i);
+        }
+      }));
+    }
+    for (auto &producer : producers) {
+      producer.join();
+    }
+    assert(v.GetSize() == static_cast<size_t>(thread_count * per_thread));
+    assert(v.IsReady(0) && !v.IsReady(v.GetSize()) && v.TryGet(v.GetSize()) == nullptr);
+
+    SimpleVector<int> frozen = v.Freeze();
+    assert(v.IsEmpty() && v.GetCapacity() == 0);
+    assert(frozen.GetSize() == static_cast<size_t>(thread_count * per_thread));
+    // Элементы одного потока идут в порядке добавления
+    SimpleVector<int> last_seen(thread_count, -1);
+    for (int x : frozen) {
+      assert(x > last_seen[x / per_thread]);
+      last_seen[x / per_thread] = x;
+    }
+    sort(frozen.begin(), frozen.end());
+    SimpleVector<int> expected(thread_count * per_thread);
+    iota(expected.begin(), expected.end(), 0);
+    assert(frozen == expected);
+  }
+  {
+    // Элементы не перемещаются при росте вектора
+    ConcurrentSimpleVector<string> v;
+    v.PushBack("first"s);
+    const string *first = v.TryGet(0);
+    for (int i = 0; i < 1000; ++i) {
+      v.EmplaceBack(10, 'a');
+    }
+    assert(v.TryGet(0) == first && *first == "first"s);
+    assert(v.At(1000) == string(10, 'a'));
+    try {
+      v.At(1001);
+      assert(false);
+    } catch (const out_of_range &) {
+    }
+    SimpleVector<string> frozen = v.Freeze();
+    assert(frozen.GetSize() == 1001 && frozen[0] == "first"s && frozen[1000] == string(10, 'a'));
+  }
+  {
+    // Сегменты можно выделить заранее
+    ConcurrentSimpleVector<int> v(1000);
+    const size_t capacity = v.GetCapacity();
+    assert(capacity >= 1000);
+    for (int i = 0; i < 1000; ++i) {
+      v.PushBack(i);
+    }
+    assert(v.GetCapacity() == capacity);
+  }
+  {
+    // Если создание элемента бросает исключение, ячейка остаётся пустой и пропускается
+    ConcurrentSimpleVector<ThrowingCopy> v;
+    v.PushBack(ThrowingCopy(1));
+    const ThrowingCopy source(2);
+    ThrowingCopy::copies_left = 0;
+    try {
+      v.PushBack(source);
+      assert(false);
+    } catch (const runtime_error &) {
+    }
+    v.PushBack(ThrowingCopy(3));
+    assert(v.GetSize() == 3 && !v.IsReady(1));
+    SimpleVector<ThrowingCopy> frozen = v.Freeze();
+    assert(frozen.GetSize() == 2 && frozen[0].GetValue() == 1 && frozen[1].GetValue() == 3);
+  }
+  {
+    // Память выделяется аллокатором вектора и передаётся SimpleVector
+    pmr::synchronized_pool_resource resource;
+    ConcurrentSimpleVector<int, pmr::polymorphic_allocator<int>> v(&resource);
+    for (int i = 0; i < 100; ++i) {
+      v.PushBack(i);
+    }
+    auto frozen = v.Freeze();
+    assert(frozen.GetAllocator().resource() == &resource);
+    assert(frozen.GetSize() == 100 && frozen[99] == 99);
+  }
+  {
+    // Потоки, одновременно дошедшие до границы сегмента, выделяют его один раз
+    CountingResource resource;
+    ConcurrentSimpleVector<int, pmr::polymorphic_allocator<int>> v(&resource);
+    const int thread_count = 8;
+    const int per_thread = 20000;
+    atomic<bool> start = false;
+    SimpleVector<thread> producers;
+    for (int t = 0; t < thread_count; ++t) {
+      producers.PushBack(thread([&v, &start] {
+        while (!start) {
+          this_thread::yield();
+        }
+        for (int i = 0; i < per_thread; ++i) {
+          v.PushBack(i);
+        }
+      }));
+    }
+    start = true;
+    for (auto &producer : producers) {
+      producer.join();
+    }
+    size_t segments = 0;
+    while ((size_t{1} << (segments + ConcurrentSimpleVector<int>::kFirstSegmentBits))
+        - (size_t{1} << ConcurrentSimpleVector<int>::kFirstSegmentBits) < v.GetSize()) {
+      ++segments;
+    }
+    assert(resource.allocations == segments);
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestSegmentedVector() {
+  cout << "Test segmented vector"s << endl;
+  {
+    // Элементы не перемещаются при росте, а вместимость растёт по блоку
+    SegmentedVector<int, 4> v;
+    v.PushBack(0);
+    const int *first = &v[0];
+    for (int i = 1; i < 100; ++i) {
+      v.PushBack(i);
+      assert(v.GetCapacity() == (v.GetSize() + 3) / 4 * 4);
+    }
+    assert(&v[0] == first && *first == 0);
+    assert(v.GetSize() == 100 && v.GetChunkCount() == 25);
+    for (int i = 0; i < 100; ++i) {
+      assert(v[i] == i && v.At(i) == i);
+    }
+    try {
+      v.At(100);
+      assert(false);
+    } catch (const out_of_range &) {
+    }
+    // Внутри блока элементы непрерывны
+    const SimpleSpan<const int> chunk = as_const(v).GetChunk(3);
+    assert(chunk.GetSize() == 4 && chunk[0] == 12 && &chunk[3] == &v[15]);
+    // EmplaceBack может ссылаться на элемент самого вектора
+    v.EmplaceBack(v[0]);
+    assert(v[100] == 0 && &v[0] == first);
+  }
+  {
+    // Итераторы произвольного доступа проходят через границы блоков
+    SegmentedVector<int, 4> v{5, 4, 3, 2, 1, 0, 9, 8, 7, 6};
+    sort(v.begin(), v.end());
+    for (int i = 0; i < 10; ++i) {
+      assert(v[i] == i);
+    }
+    assert(v.end() - v.begin() == 10 && *(v.begin() + 5) == 5 && v.cbegin()[9] == 9);
+    SegmentedVector<int, 4>::ConstIterator it = v.begin();
+    assert(it == v.cbegin() && it < v.cend());
+    assert(accumulate(v.begin(), v.end(), 0) == 45);
+  }
+  {
+    // Вставка и удаление в середине сдвигают элементы
+    SegmentedVector<string, 4> v;
+    for (int i = 0; i < 6; ++i) {
+      v.PushBack(to_string(i));
+    }
+    auto it = v.Insert(v.begin() + 1, "a"s);
+    assert(*it == "a"s && v.GetSize() == 7 && v[0] == "0"s && v[1] == "a"s && v[6] == "5"s);
+    it = v.Erase(v.begin());
+    assert(*it == "a"s && v.GetSize() == 6 && v[5] == "5"s);
+    const SimpleVector<string> source{"x"s, "y"s, "z"s};
+    it = v.Insert(v.begin() + 2, source.begin(), source.end());
+    assert(*it == "x"s && v.GetSize() == 9 && v[4] == "z"s && v[5] == "2"s && v[8] == "5"s);
+    it = v.Insert(v.end(), 3, "w"s);
+    assert(it == v.begin() + 9 && v.GetSize() == 12 && v[11] == "w"s);
+    v.PopBack();
+    v.Resize(3);
+    assert(v.GetSize() == 3 && v[2] == "x"s);
+    v.Resize(6);
+    assert(v.GetSize() == 6 && v[5].empty());
+    v.Assign(source.begin(), source.end());
+    assert(v.GetSize() == 3 && v[0] == "x"s && v[2] == "z"s);
+  }
+  {
+    // Копирование, перемещение, обмен и сравнение
+    SegmentedVector<int, 4> a(10, 7);
+    SegmentedVector<int, 4> b(a);
+    assert(a == b && !(a < b));
+    b.PushBack(1);
+    assert(a != b && a < b && b > a && a <= b);
+    b[0] = 1;
+    assert(b < a);
+    const int *data = &a[0];
+    SegmentedVector<int, 4> moved(std::move(a));
+    assert(a.IsEmpty() && a.GetCapacity() == 0 && &moved[0] == data);
+    a = moved;
+    assert(a == moved && &a[0] != data);
+    b = std::move(moved);
+    assert(&b[0] == data && moved.IsEmpty());
+    a.swap(b);
+    assert(&a[0] == data);
+    SegmentedVector<int, 4> c(5);
+    assert(c.GetSize() == 5 && c[4] == 0);
+  }
+  {
+    // Reserve выделяет блоки, не трогая элементы, а ShrinkToFit освобождает пустые
+    SegmentedVector<int, 4> v{1, 2, 3};
+    const int *first = &v[0];
+    v.Reserve(17);
+    assert(v.GetCapacity() == 20 && &v[0] == first);
+    v.ShrinkToFit();
+    assert(v.GetCapacity() == 4 && &v[0] == first);
+    v.Reset();
+    assert(v.IsEmpty() && v.GetCapacity() == 0);
+  }
+  {
+    // Если создание элементов бросает исключение, вектор остаётся прежним
+    Counted::ResetCounters();
+    {
+      SegmentedVector<ThrowingCopy, 4> v;
+      for (int i = 0; i < 5; ++i) {
+        v.PushBack(ThrowingCopy(i));
+      }
+      ThrowingCopy::copies_left = 7;
+      const SimpleVector<ThrowingCopy> source(7, ThrowingCopy(9));
+      ThrowingCopy::copies_left = 4;
+      try {
+        v.Append(source.begin(), source.end());
+        assert(false);
+      } catch (const runtime_error &) {
+      }
+      assert(v.GetSize() == 5 && v[4].GetValue() == 4);
+    }
+    {
+      SegmentedVector<Counted, 4> v(6);
+      v.Erase(v.begin() + 2);
+      v.Resize(3);
+    }
+    assert(Counted::constructed == Counted::destroyed);
+  }
+  {
+    // Блоки и каталог выделяются аллокатором вектора
+    pmr::monotonic_buffer_resource resource;
+    SegmentedVector<int, 8, pmr::polymorphic_allocator<int>> v(&resource);
+    for (int i = 0; i < 100; ++i) {
+      v.PushBack(i);
+    }
+    assert(v.GetAllocator().resource() == &resource);
+    SegmentedVector<int, 8, pmr::polymorphic_allocator<int>> copy(v);
+    assert(copy == v && copy.GetAllocator().resource() != &resource);
+  }
+  {
+    // Размер блока по умолчанию - степень двойки
+    constexpr size_t chunk_size = SegmentedVector<double>::kChunkSize;
+    static_assert(chunk_size == 8192 && (chunk_size & (chunk_size - 1)) == 0);
+    static_assert(SegmentedVector<array<char, 100000>>::kChunkSize == 1);
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestSoAVector() {
+  cout << "Test SoA vector"s << endl;
+  {
+    // Каждое поле хранится в своём непрерывном массиве с общими размером и вместимостью
+    SoAVector<int, double, string> v;
+    for (int i = 0; i < 100; ++i) {
+      v.PushBack({i, i * 0.5, to_string(i)});
+    }
+    assert(v.GetSize() == 100 && v.GetCapacity() >= 100);
+    const SimpleSpan<int> ids = v.Column<0>();
+    assert(ids.GetSize() == 100 && &ids[1] == &ids[0] + 1);
+    assert(accumulate(ids.begin(), ids.end(), 0) == 4950);
+    assert(v.Get<1>(10) == 5.0 && v.Get<2>(99) == "99"s);
+    // Строка - кортеж ссылок на поля
+    auto [id, weight, name] = v[42];
+    assert(id == 42 && weight == 21.0 && name == "42"s);
+    get<2>(v[42]) = "answer"s;
+    assert(v.At(42) == make_tuple(42, 21.0, "answer"s));
+    try {
+      v.At(100);
+      assert(false);
+    } catch (const out_of_range &) {
+    }
+    // EmplaceBack создаёт каждое поле из своего аргумента
+    auto row = v.EmplaceBack(-1, 1.5, "zzz");
+    assert(get<0>(row) == -1 && get<2>(row) == "zzz"s && v.GetSize() == 101);
+    v.PopBack();
+    assert(v.GetSize() == 100);
+  }
+  {
+    // Итератор по строкам проходит по всем полям сразу
+    SoAVector<int, char> v;
+    v.PushBack({1, 'a'});
+    v.PushBack({2, 'b'});
+    v.PushBack({3, 'c'});
+    string letters;
+    int sum = 0;
+    for (auto [number, letter] : v) {
+      sum += number;
+      letters += letter;
+    }
+    assert(sum == 6 && letters == "abc"s);
+    SoAVector<int, char>::ConstIterator it = v.begin() + 1;
+    assert(it - v.cbegin() == 1 && get<1>(*it) == 'b' && it < v.cend() && v.end() - v.begin() == 3);
+    auto next = v.Erase(it);
+    assert(get<0>(*next) == 3 && v.GetSize() == 2 && v.Get<1>(1) == 'c');
+  }
+  {
+    // Копирование, перемещение, Resize и ShrinkToFit
+    SoAVector<int, string> v(3);
+    assert(v.GetSize() == 3 && v.Get<0>(2) == 0 && v.Get<1>(2).empty());
+    v.Get<1>(0) = "x"s;
+    SoAVector<int, string> copy(v);
+    assert(copy == v);
+    copy.Get<0>(1) = 5;
+    assert(copy != v);
+    const int *column = v.Column<0>().Data();
+    SoAVector<int, string> moved(std::move(v));
+    assert(v.IsEmpty() && moved.Column<0>().Data() == column);
+    v = moved;
+    assert(v == moved);
+    moved.Resize(1);
+    moved.ShrinkToFit();
+    assert(moved.GetSize() == 1 && moved.GetCapacity() == 1 && moved.Get<1>(0) == "x"s);
+    moved.Reset();
+    assert(moved.GetCapacity() == 0);
+  }
+  {
+    // Если перенос поля бросает исключение, перенесённые поля разрушаются, и вектор не меняется
+    Counted::ResetCounters();
+    {
+      SoAVector<Counted, ThrowingCopy> v;
+      v.Reserve(2);
+      v.EmplaceBack(Counted(), ThrowingCopy(1));
+      v.EmplaceBack(Counted(), ThrowingCopy(2));
+      const size_t capacity = v.GetCapacity();
+      ThrowingCopy::copies_left = 1;
+      try {
+        v.Reserve(capacity * 2);
+        assert(false);
+      } catch (const runtime_error &) {
+      }
+      assert(v.GetCapacity() == capacity && v.GetSize() == 2 && v.Get<1>(1).GetValue() == 2);
+      // Если бросает создание поля, поля строки, созданные до него, разрушаются
+      const ThrowingCopy source(3);
+      ThrowingCopy::copies_left = 0;
+      try {
+        v.EmplaceBack(Counted(), source);
+        assert(false);
+      } catch (const runtime_error &) {
+      }
+      assert(v.GetSize() == 2);
+    }
+    assert(Counted::constructed == Counted::destroyed);
+  }
+  {
+    // Поля с перемещением без исключений переносятся после копирования остальных,
+    // поэтому исключение при копировании не оставляет их перемещёнными
+    SoAVector<string, ThrowingCopy> v;
+    v.Reserve(2);
+    v.EmplaceBack(string(100, 'a'), ThrowingCopy(1));
+    v.EmplaceBack(string(100, 'b'), ThrowingCopy(2));
+    ThrowingCopy::copies_left = 1;
+    try {
+      v.Reserve(v.GetCapacity() * 2);
+      assert(false);
+    } catch (const runtime_error &) {
+    }
+    assert(v.Get<0>(0) == string(100, 'a') && v.Get<0>(1) == string(100, 'b'));
+    assert(v.Get<1>(0).GetValue() == 1 && v.Get<1>(1).GetValue() == 2);
+    ThrowingCopy::copies_left = 2;
+    v.Reserve(v.GetCapacity() * 2);
+    assert(v.Get<0>(1) == string(100, 'b') && v.Get<1>(1).GetValue() == 2);
+  }
+  {
+    // При перемещении с неравными аллокаторами pmr строки переносятся в память своего аллокатора
+    using PmrSoAVector = BasicSoAVector<pmr::polymorphic_allocator<byte>, DoublingGrowth, int, pmr::string>;
+    static_assert(!is_nothrow_move_assignable_v<PmrSoAVector>);
+    static_assert(is_nothrow_move_assignable_v<SoAVector<int, string>>);
+    pmr::monotonic_buffer_resource resource;
+    PmrSoAVector source;
+    source.EmplaceBack(1, pmr::string(40, 'a'));
+    source.EmplaceBack(2, pmr::string(40, 'b'));
+    PmrSoAVector moved(&resource);
+    moved = move(source);
+    assert(moved.GetAllocator().resource() == &resource);
+    assert(moved.GetSize() == 2 && moved.Get<0>(1) == 2 && moved.Get<1>(1) == pmr::string(40, 'b'));
+    assert(moved.Get<1>(0).get_allocator().resource() == &resource);
+    assert(source.IsEmpty());
+
+    // Аллокаторы равны: память забирается целиком
+    const int *column = moved.Column<0>().Data();
+    PmrSoAVector stolen(&resource);
+    stolen = move(moved);
+    assert(stolen.Column<0>().Data() == column && moved.IsEmpty());
+  }
+  {
+    // Массивы полей AlignedSoAVector выровнены по кэш-линии
+    AlignedSoAVector<float, char> v(10);
+    assert(reinterpret_cast<uintptr_t>(v.AlignedColumnData<0>()) % 64 == 0);
+    assert(reinterpret_cast<uintptr_t>(v.AlignedColumnData<1>()) % 64 == 0);
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestGapBuffer() {
+  cout << "Test gap buffer"s << endl;
+  {
+    // Вставки и удаления у курсора не перемещают остальные элементы
+    GapBuffer<char> text;
+    const string hello = "hello world"s;
+    text.Append(hello.begin(), hello.end());
+    assert(text.GetSize() == 11 && text.GetGapPosition() == 11);
+    auto it = text.Insert(text.begin() + 5, ',');
+    assert(*it == ',' && text.GetGapPosition() == 6);
+    const size_t capacity = text.GetCapacity();
+    text.Insert(text.begin() + 6, '!');
+    text.Erase(text.begin() + 6);
+    assert(text.GetGapPosition() == 6 && text.GetCapacity() == capacity);
+    // Удаление перед курсором (backspace) переносит разрыв на одну позицию
+    text.Erase(text.begin() + 5);
+    assert(text.GetGapPosition() == 5);
+    const string bracket = "[]"s;
+    text.Insert(text.cbegin(), bracket.begin(), bracket.end());
+    assert(text.GetGapPosition() == 2 && text[0] == '[' && text[2] == 'h');
+    text.Erase(text.begin(), text.begin() + 2);
+    const SimpleSpan<char> compact = text.Compact();
+    assert(text.IsCompact() && string(compact.begin(), compact.end()) == hello);
+    assert(string(text.begin(), text.end()) == hello && text.At(10) == 'd');
+    try {
+      text.At(11);
+      assert(false);
+    } catch (const out_of_range &) {
+    }
+  }
+  {
+    // Разрыв переносится к позиции правки, порядок элементов сохраняется
+    GapBuffer<string> v;
+    for (int i = 0; i < 10; ++i) {
+      v.PushBack(to_string(i));
+    }
+    v.Insert(v.begin() + 3, "a"s);
+    v.Insert(v.begin() + 8, 2, "b"s);
+    v.Erase(v.begin());
+    v.Insert(v.end(), v[0]);
+    const SimpleVector<string> expected{"1"s, "2"s, "a"s, "3"s, "4"s, "5"s, "6"s, "b"s, "b"s, "7"s, "8"s, "9"s,
+                                        "1"s};
+    assert(v.GetSize() == expected.GetSize() && equal(v.begin(), v.end(), expected.begin()));
+    v.PopBack();
+    assert(v.GetSize() == 12 && v[11] == "9"s);
+    GapBuffer<string> copy(v);
+    assert(copy == v && copy.IsCompact() && copy.GetCapacity() == 12);
+    copy[0] = "0"s;
+    assert(copy < v && copy != v);
+    GapBuffer<string> moved(std::move(copy));
+    assert(copy.IsEmpty() && moved[0] == "0"s);
+    v.ShrinkToFit();
+    assert(v.GetCapacity() == v.GetSize() && v.GetGapSize() == 0);
+    v.Clear();
+    assert(v.IsEmpty() && v.GetGapSize() == v.GetCapacity());
+  }
+  {
+    // Если перенос элементов бросает исключение, содержимое буфера не меняется
+    GapBuffer<ThrowingCopy> v;
+    ThrowingCopy::copies_left = 100;
+    for (int i = 0; i < 4; ++i) {
+      v.EmplaceBack(i);
+    }
+    ThrowingCopy::copies_left = 2;
+    try {
+      v.Insert(v.begin(), ThrowingCopy(10));
+      assert(false);
+    } catch (const runtime_error &) {
+    }
+    assert(v.GetSize() == 4);
+    for (int i = 0; i < 4; ++i) {
+      assert(v[i].GetValue() == i);
+    }
+    // Перенос разрыва, прерванный на середине, оставляет элементы в прежнем порядке
+    ThrowingCopy::copies_left = 100;
+    v.Reserve(8);
+    v.Compact();
+    ThrowingCopy::copies_left = 2;
+    try {
+      v.Insert(v.begin(), ThrowingCopy(10));
+      assert(false);
+    } catch (const runtime_error &) {
+    }
+    assert(v.GetSize() == 4 && v.GetGapPosition() == 2);
+    for (int i = 0; i < 4; ++i) {
+      assert(v[i].GetValue() == i);
+    }
+  }
+  {
+    Counted::ResetCounters();
+    {
+      GapBuffer<Counted> v(10);
+      v.Erase(v.begin() + 3, v.begin() + 6);
+      v.Insert(v.begin() + 1, Counted());
+      v.Compact();
+      v.Reserve(100);
+    }
+    assert(Counted::constructed == Counted::destroyed);
+  }
+  {
+    // Аллокаторы pmr не передаются при перемещении: если они не равны,
+    // элементы перемещаются в память своего аллокатора
+    using PmrBuffer = GapBuffer<pmr::string, pmr::polymorphic_allocator<pmr::string>>;
+    static_assert(!is_nothrow_move_assignable_v<PmrBuffer>);
+    static_assert(is_nothrow_move_assignable_v<GapBuffer<string>>);
+    pmr::monotonic_buffer_resource resource;
+    PmrBuffer source;
+    for (int i = 0; i < 4; ++i) {
+      source.PushBack(pmr::string(40, static_cast<char>('a' + i)));
+    }
+    source.Erase(source.begin() + 1);
+    source.Insert(source.begin() + 1, pmr::string(40, 'x'));
+    PmrBuffer moved(&resource);
+    moved = move(source);
+    assert(moved.GetAllocator().resource() == &resource);
+    assert(moved.GetSize() == 4 && moved[1] == pmr::string(40, 'x') && moved[3] == pmr::string(40, 'd'));
+    assert(moved[0].get_allocator().resource() == &resource);
+    assert(source.IsEmpty());
+
+    // Аллокаторы равны: память забирается целиком
+    PmrBuffer stolen(&resource);
+    const pmr::string *first = &moved[0];
+    stolen = move(moved);
+    assert(&stolen[0] == first && moved.IsEmpty());
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestCowSimpleVector() {
+  cout << "Test copy-on-write vector"s << endl;
+  // Копия разделяет буфер, чтение его не копирует
+  {
+    CowSimpleVector<string> v{"a"s, "b"s, "c"s};
+    assert(!v.IsShared());
+    CowSimpleVector<string> snapshot = v;
+    assert(v.IsShared() && snapshot.IsShared());
+    assert(snapshot.Data() == v.Data() && snapshot == v);
+    assert(as_const(snapshot)[1] == "b"s && as_const(snapshot).At(2) == "c"s);
+    assert(snapshot.Data() == v.Data());
+
+    // Запись копирует разделённый буфер, снимок не меняется
+    v[0] = "x"s;
+    assert(!v.IsShared() && !snapshot.IsShared());
+    assert(v.Data() != snapshot.Data());
+    assert(v[0] == "x"s && snapshot[0] == "a"s && v != snapshot);
+    // Буфер больше не разделён, и запись его не копирует
+    const string *data = v.Data();
+    v[1] = "y"s;
+    v.At(2) = "z"s;
+    assert(v.Data() == data);
+    assert((v == CowSimpleVector<string>{"x"s, "y"s, "z"s}) && snapshot < v);
+  }
+  // Вставка в разделённый буфер копирует его сразу с местом для нового элемента
+  {
+    CowSimpleVector<int> v{1, 2, 3};
+    const CowSimpleVector<int> snapshot = v;
+    v.PushBack(4);
+    assert(v.GetCapacity() > 4);
+    const int *data = v.Data();
+    v.PushBack(5);
+    assert(v.Data() == data);
+    auto it = v.Insert(v.begin() + 1, 10);
+    assert(*it == 10);
+    assert((v == CowSimpleVector<int>{1, 10, 2, 3, 4, 5}));
+    assert((snapshot == CowSimpleVector<int>{1, 2, 3}));
+
+    // Удаление из разделённого буфера копирует только остающиеся элементы
+    CowSimpleVector<int> copy = v;
+    it = copy.Erase(copy.begin() + 1, copy.begin() + 3);
+    assert(*it == 3 && copy.GetCapacity() == 4);
+    assert((copy == CowSimpleVector<int>{1, 3, 4, 5}));
+    copy.Erase(copy.begin());
+    copy.PopBack();
+    assert((copy == CowSimpleVector<int>{3, 4}));
+    assert(v.GetSize() == 6 && !v.IsShared());
+
+    CowSimpleVector<int> popped = v;
+    popped.PopBack();
+    assert(popped.GetSize() == 5 && v.GetSize() == 6 && popped < v);
+  }
+  // Clear не копирует разделённый буфер, а Resize копирует только остающиеся элементы
+  {
+    CowSimpleVector<int> v(5, 7);
+    CowSimpleVector<int> cleared = v;
+    cleared.Clear();
+    assert(cleared.IsEmpty() && cleared.Data() == nullptr && v.GetSize() == 5);
+    cleared.PushBack(1);
+    assert(cleared.GetSize() == 1 && cleared[0] == 1);
+
+    CowSimpleVector<int> resized = v;
+    resized.Resize(2);
+    assert(resized.GetSize() == 2 && v.GetSize() == 5);
+    // value может лежать в разделённом буфере
+    CowSimpleVector<int> filled = v;
+    filled.Resize(8, as_const(v)[0]);
+    assert(filled.GetSize() == 8 && filled[7] == 7);
+    filled.Reserve(100);
+    assert(filled.GetCapacity() == 100);
+    // Reserve не копирует разделённый буфер, если вместимости хватает,
+    // а иначе копирует его ровно с запрошенной вместимостью
+    CowSimpleVector<int> reserved = filled;
+    reserved.Reserve(filled.GetCapacity());
+    assert(reserved.IsShared() && reserved.Data() == filled.Data());
+    reserved.Reserve(101);
+    assert(!reserved.IsShared() && reserved.GetCapacity() == 101 && reserved == filled);
+
+    CowSimpleVector<int> empty;
+    assert(empty.IsEmpty() && empty.begin() == empty.end() && empty == CowSimpleVector<int>());
+    empty.Reserve(3);
+    assert(empty.GetCapacity() == 3 && empty.IsEmpty());
+    swap(empty, cleared);
+    assert(empty.GetSize() == 1 && cleared.IsEmpty());
+  }
+  // Вектор забирает элементы SimpleVector без копирования
+  {
+    SimpleVector<int> source{1, 2, 3};
+    const int *data = source.Data();
+    CowSimpleVector<int> v(move(source));
+    assert(v.Data() == data && v.GetVector().GetSize() == 3);
+  }
+  {
+    Counted::ResetCounters();
+    {
+      CowSimpleVector<Counted> v(3);
+      auto a = v;
+      auto b = v;
+      a.PushBack(Counted());
+      b.Erase(b.begin());
+      v[0] = Counted();
+    }
+    assert(Counted::constructed == Counted::destroyed);
+  }
+  // Снимки раздаются потокам-читателям, пока владелец изменяет свою копию
+  {
+    CowSimpleVector<int> config(1000, 1);
+    SimpleVector<thread> readers;
+    atomic<int> total = 0;
+    for (int i = 0; i < 4; ++i) {
+      readers.EmplaceBack([snapshot = config, &total] {
+        int sum = 0;
+        for (int x : snapshot) {
+          sum += x;
+        }
+        total += sum;
+      });
+    }
+    for (int i = 0; i < 1000; ++i) {
+      config[i] = 2;
+    }
+    for (auto &reader : readers) {
+      reader.join();
+    }
+    assert(total == 4000);
+    assert(config.GetSize() == 1000 && config[999] == 2 && !config.IsShared());
+  }
+  cout << "Done!"s << endl << endl;
+}
+
+void TestSmallVector() {
+  cout << "Test small vector"s << endl;
+  // Первые N элементов хранятся внутри вектора
+  {
+    size_t allocations = 0;
+    using Alloc = TrackingAllocator<int>;
+    SmallVector<int, 4, Alloc> v(Alloc(1, &allocations));
+    for (int i = 0; i < 4; ++i) {
+      v.PushBack(i);
+    }
+    assert(v.IsInline());
+    assert(v.GetCapacity() == 4);
+    assert(allocations == 0);
+    v.Insert(v.begin(), 42);
+    assert(!v.IsInline());
+    assert(v.GetCapacity() == 8);
+    assert(allocations == 1);
+    assert((v == SmallVector<int, 4, Alloc>({42, 0, 1, 2, 3}, Alloc(1, &allocations))));
+
+    // Копирующее присваивание использует существующую вместимость
+    SmallVector<int, 4, Alloc> copy(Alloc(1, &allocations));
+    copy.Reserve(6);
+    allocations = 0;
+    copy = v;
+    assert(copy == v && copy.GetCapacity() == 6 && allocations == 0);
+    const SmallVector<int, 4, Alloc> shorter({1, 2}, Alloc(1, &allocations));
+    copy = shorter;
+    assert(copy == shorter && copy.GetCapacity() == 6 && allocations == 0);
+    SmallVector<int, 4, Alloc> inline_copy(Alloc(1, &allocations));
+    inline_copy = shorter;
+    assert(inline_copy == shorter && inline_copy.IsInline() && allocations == 0);
+    v.Erase(v.begin() + 1);
+    assert(v[1] == 1 && v.GetSize() == 4);
+
+    // Передаваемый аллокатор забирается и у вектора, хранящего элементы в себе
+    SmallVector<int, 4, Alloc> inline_source({7, 8}, Alloc(2, &allocations));
+    v = move(inline_source);
+    assert(v.GetAllocator().GetId() == 2 && v.IsInline());
+    assert((v == SmallVector<int, 4, Alloc>({7, 8}, Alloc(2, &allocations))));
+  }
+
+  {
+    SmallVector<string, 2> v{"a"s, "b"s};
+    assert(v.IsInline());
+    SmallVector<string, 2> w(Reserve(5));
+    assert(!w.IsInline() && w.GetCapacity() == 5);
+    v.Reserve(3);
+    assert(!v.IsInline() && v.GetCapacity() == 3);
+    assert((v == SmallVector<string, 2>{"a"s, "b"s}));
+    v.Resize(1);
+    v.EmplaceBack(3u, 'c');
+    assert((v == SmallVector<string, 2>{"a"s, "ccc"s}));
+    assert((SmallVector<int, 2>{1, 2} < SmallVector<int, 2>{1, 2, 3}));
+    assert((SmallVector<int, 2>{1, 3} > SmallVector<int, 2>{1, 2, 3}));
+  }
+
+  // Перемещение и обмен во всех сочетаниях встроенного хранения и кучи
+  {
+    SmallVector<X, 2> inline_vector;
+    inline_vector.EmplaceBack(1u);
+    SmallVector<X, 2> heap_vector;
+    for (size_t i = 10; i < 15; ++i) {
+      heap_vector.EmplaceBack(i);
+    }
+    const X *heap_begin = heap_vector.begin();
+
+    SmallVector<X, 2> moved_inline(move(inline_vector));
+    assert(moved_inline.IsInline() && moved_inline[0].GetX() == 1);
+    assert(inline_vector.IsEmpty());
+
+    SmallVector<X, 2> moved_heap(move(heap_vector));
+    assert(moved_heap.begin() == heap_begin);
+    assert(heap_vector.IsEmpty() && heap_vector.IsInline());
+
+    moved_inline.swap(moved_heap);
+    assert(moved_inline.begin() == heap_begin && moved_inline.GetSize() == 5);
+    assert(moved_heap.IsInline() && moved_heap.GetSize() == 1 && moved_heap[0].GetX() == 1);
+
+    SmallVector<X, 2> other_heap;
+    for (size_t i = 20; i < 23; ++i) {
+      other_heap.EmplaceBack(i);
+    }
+    const X *other_begin = other_heap.begin();
+    moved_inline.swap(other_heap);
+    assert(moved_inline.begin() == other_begin && other_heap.begin() == heap_begin);
+
+    other_heap = move(moved_heap);
+    assert(other_heap.GetSize() == 1 && other_heap[0].GetX() == 1);
+    moved_heap = move(moved_inline);
+    assert(moved_heap.begin() == other_begin && moved_heap[2].GetX() == 22);
+  }
+
+  // Копирование
+  {
+    SmallVector<string, 3> v{"a"s, "b"s};
+    auto copy(v);
+    assert(copy == v && copy.IsInline());
+    v.PushBack("c"s);
+    v.PushBack("d"s);
+    copy = v;
+    assert(copy == v && !copy.IsInline());
+    assert(copy.begin() != v.begin());
+  }
+  cout << "Done!"s << endl << endl;
+}
+
 void TestTemporaryObjConstructor() {
   const size_t size = 1000000;
   cout << "Test with temporary object, copy elision"s << endl;
@@ -368,7 +2886,7 @@ void TestNamedMoveConstructor() {
   SimpleVector<int> moved_vector(move(vector_to_move));
   assert(moved_vector.GetSize() == size);
   assert(vector_to_move.GetSize() == 0);
-  assert(&vector_to_move[0] == nullptr);
+  assert(vector_to_move.Data() == nullptr);
   cout << "Done!"s << endl << endl;
 }
 
@@ -382,7 +2900,7 @@ void TestNamedMoveOperator() {
   moved_vector = move(vector_to_move);
   assert(moved_vector.GetSize() == size);
   assert(vector_to_move.GetSize() == 0);
-  assert(&vector_to_move[0] == nullptr);
+  assert(vector_to_move.Data() == nullptr);
   cout << "Done!"s << endl << endl;
 }
 
@@ -465,11 +2983,40 @@ int main() {
   TestPushBack();
   TestPopBack();
   TestComparison();
+  TestSimdComparison();
   TestSwap();
   TestInsert();
   TestErase();
+  TestShrinkToFit();
+  TestRangeOperations();
   TestReserveConstructor();
   TestReserveMethod();
+  TestRawStorage();
+  TestEmplace();
+  TestTriviallyCopyable();
+  TestStrongExceptionGuarantee();
+  TestGrowthPolicy();
+  TestAllocator();
+  TestSmallVector();
+  TestInstrumentation();
+  TestParallelAlgorithms();
+  TestParallelInit();
+  TestAlignedStorage();
+  TestMappedVector();
+  TestSerialization();
+  TestVectorIo();
+  TestSimpleSpan();
+#ifdef SIMPLE_VECTOR_HAS_CONSTEXPR
+  TestConstexpr();
+#endif
+#ifdef SIMPLE_VECTOR_CHECKED_ITERATORS
+  TestCheckedIterators();
+#endif
+  TestConcurrentSimpleVector();
+  TestSegmentedVector();
+  TestSoAVector();
+  TestGapBuffer();
+  TestCowSimpleVector();
   TestTemporaryObjConstructor();
   TestTemporaryObjOperator();
   TestNamedMoveConstructor();
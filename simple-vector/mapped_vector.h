@@ -0,0 +1,377 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file_header.h"
+#include "growth_policy.h"
+#include "memory_utils.h"
+
+enum class MappedFileMode {
+  // Открывает существующий файл или создаёт пустой
+  kOpenOrCreate,
+  // Создаёт пустой файл, стирая прежнее содержимое
+  kTruncate,
+};
+
+// Вектор, элементы которого хранятся в отображённом в память файле (mmap).
+// Файл начинается с заголовка detail::FileHeader, за которым лежат элементы,
+// поэтому при открытии ничего не читается и не копируется: страницы подгружаются
+// при первом обращении, и вектор может быть больше оперативной памяти.
+// Вместимость определяется размером файла; при росте файл увеличивается
+// и отображение расширяется (mremap). Размер вектора хранится в заголовке.
+// Type должен быть тривиально копируемым, потому что его байты пишутся в файл как есть
+template<typename Type, typename GrowthPolicy = DoublingGrowth>
+class MappedVector {
+  static_assert(std::is_trivially_copyable_v<Type>, "MappedVector stores elements as raw bytes");
+  static_assert(alignof(Type) <= sizeof(detail::FileHeader), "elements must fit the alignment after the header");
+
+ public:
+  using Iterator = Type *;
+  using ConstIterator = const Type *;
+
+  // Отображает в память файл path, создавая его при необходимости.
+  // Бросает std::system_error при ошибке ввода-вывода и std::runtime_error,
+  // если файл не содержит элементов типа Type
+  explicit MappedVector(const std::string &path, MappedFileMode mode = MappedFileMode::kOpenOrCreate)
+      : path_(path) {
+    const int flags = O_RDWR | O_CREAT | (mode == MappedFileMode::kTruncate ? O_TRUNC : 0);
+    fd_ = ::open(path.c_str(), flags, 0644);
+    if (fd_ < 0) {
+      ThrowSystemError("open");
+    }
+    try {
+      struct stat st {};
+      if (::fstat(fd_, &st) != 0) {
+        ThrowSystemError("fstat");
+      }
+      if (st.st_size == 0) {
+        ResizeFile(PageRound(sizeof(detail::FileHeader)));
+        GetHeader() = detail::MakeFileHeader(sizeof(Type), 0);
+      } else {
+        if (static_cast<size_t>(st.st_size) < sizeof(detail::FileHeader)) {
+          throw std::runtime_error("SimpleVector file " + path + " is truncated");
+        }
+        Map(st.st_size);
+        detail::ValidateFileHeader(GetHeader(), sizeof(Type));
+        if (GetHeader().size > GetCapacity()) {
+          throw std::runtime_error("SimpleVector file " + path + " is truncated");
+        }
+      }
+    } catch (...) {
+      Close();
+      throw;
+    }
+  }
+
+  MappedVector(const MappedVector &) = delete;
+  MappedVector &operator=(const MappedVector &) = delete;
+
+  MappedVector(MappedVector &&other) noexcept
+      : path_(std::move(other.path_)),
+        fd_(std::exchange(other.fd_, -1)),
+        mapping_(std::exchange(other.mapping_, nullptr)),
+        mapping_size_(std::exchange(other.mapping_size_, 0)) {
+  }
+
+  MappedVector &operator=(MappedVector &&rhs) noexcept {
+    if (this != &rhs) {
+      Close();
+      path_ = std::move(rhs.path_);
+      fd_ = std::exchange(rhs.fd_, -1);
+      mapping_ = std::exchange(rhs.mapping_, nullptr);
+      mapping_size_ = std::exchange(rhs.mapping_size_, 0);
+    }
+    return *this;
+  }
+
+  // Снимает отображение и закрывает файл. Несохранённые на диск изменения
+  // записывает ядро; для гарантии сохранности нужно вызвать Sync()
+  ~MappedVector() {
+    Close();
+  }
+
+  const std::string &GetPath() const noexcept {
+    return path_;
+  }
+
+  size_t GetSize() const noexcept {
+    return mapping_ ? GetHeader().size : 0;
+  }
+
+  size_t GetCapacity() const noexcept {
+    return mapping_ ? (mapping_size_ - sizeof(detail::FileHeader)) / sizeof(Type) : 0;
+  }
+
+  bool IsEmpty() const noexcept {
+    return GetSize() == 0;
+  }
+
+  Type &operator[](size_t index) noexcept {
+    assert(index < GetSize());
+    return Data()[index];
+  }
+
+  const Type &operator[](size_t index) const noexcept {
+    assert(index < GetSize());
+    return Data()[index];
+  }
+
+  Type &At(size_t index) {
+    if (index >= GetSize()) {
+      throw std::out_of_range("Index is out of range");
+    }
+    return Data()[index];
+  }
+
+  const Type &At(size_t index) const {
+    if (index >= GetSize()) {
+      throw std::out_of_range("Index is out of range");
+    }
+    return Data()[index];
+  }
+
+  // Обнуляет размер вектора, не уменьшая файл
+  void Clear() noexcept {
+    SetSize(0);
+  }
+
+  // Изменяет размер вектора. Новые элементы инициализируются значением по умолчанию
+  void Resize(size_t new_size) {
+    if (new_size > GetSize()) {
+      if (new_size > GetCapacity()) {
+        Reserve(CalculateCapacity(new_size));
+      }
+      std::fill(end(), Data() + new_size, Type());
+    }
+    SetSize(new_size);
+  }
+
+  // Изменяет размер вектора, не записывая ничего в память новых элементов.
+  // Память, до которой впервые вырос файл, заполнена нулями, а ранее удалённые
+  // элементы сохраняют прежние значения
+  void ResizeUninitialized(size_t new_size) {
+    if (new_size > GetCapacity()) {
+      Reserve(CalculateCapacity(new_size));
+    }
+    SetSize(new_size);
+  }
+
+  void PushBack(const Type &item) {
+    if (GetSize() == GetCapacity()) {
+      // item может лежать в файле, отображение которого сейчас переместится
+      const Type copy(item);
+      Reserve(CalculateCapacity(GetSize() + 1));
+      Data()[GetSize()] = copy;
+    } else {
+      Data()[GetSize()] = item;
+    }
+    SetSize(GetSize() + 1);
+  }
+
+  void PopBack() noexcept {
+    assert(!IsEmpty());
+    SetSize(GetSize() - 1);
+  }
+
+  // Вставляет значение value в позицию pos.
+  // Возвращает итератор на вставленное значение
+  Iterator Insert(ConstIterator pos, const Type &value) {
+    assert(pos >= begin() && pos <= end());
+    const size_t index = pos - begin();
+    const Type copy(value);
+    if (GetSize() == GetCapacity()) {
+      Reserve(CalculateCapacity(GetSize() + 1));
+    }
+    detail::MoveBackward(begin() + index, end(), end() + 1);
+    Data()[index] = copy;
+    SetSize(GetSize() + 1);
+    return begin() + index;
+  }
+
+  // Удаляет элемент вектора в указанной позиции
+  Iterator Erase(ConstIterator pos) noexcept {
+    assert(pos >= begin() && pos < end());
+    const size_t index = pos - begin();
+    detail::MoveForward(begin() + index + 1, end(), begin() + index);
+    SetSize(GetSize() - 1);
+    return begin() + index;
+  }
+
+  // Увеличивает файл так, чтобы в нём поместилось не меньше new_capacity элементов.
+  // Размер файла округляется до страницы, и вся округлённая память идёт под элементы.
+  // Итераторы и ссылки на элементы становятся недействительными
+  void Reserve(size_t new_capacity) {
+    if (new_capacity <= GetCapacity()) {
+      return;
+    }
+    const size_t max_capacity = (std::numeric_limits<size_t>::max() / 2 - sizeof(detail::FileHeader)) / sizeof(Type);
+    if (new_capacity > max_capacity) {
+      throw std::length_error("MappedVector capacity is too large");
+    }
+    ResizeFile(PageRound(sizeof(detail::FileHeader) + new_capacity * sizeof(Type)));
+  }
+
+  // Уменьшает файл до размера вектора, округлённого до страницы
+  void ShrinkToFit() {
+    const size_t bytes = PageRound(sizeof(detail::FileHeader) + GetSize() * sizeof(Type));
+    if (bytes < mapping_size_) {
+      ResizeFile(bytes);
+    }
+  }
+
+  // Ставит изменённые страницы в очередь на запись на диск, не дожидаясь её
+  void Flush() {
+    if (mapping_ && ::msync(mapping_, mapping_size_, MS_ASYNC) != 0) {
+      ThrowSystemError("msync");
+    }
+  }
+
+  // Записывает изменённые страницы и метаданные файла на диск и дожидается окончания записи
+  void Sync() {
+    if (!mapping_) {
+      return;
+    }
+    if (::msync(mapping_, mapping_size_, MS_SYNC) != 0) {
+      ThrowSystemError("msync");
+    }
+    if (::fsync(fd_) != 0) {
+      ThrowSystemError("fsync");
+    }
+  }
+
+  void swap(MappedVector &other) noexcept {
+    std::swap(path_, other.path_);
+    std::swap(fd_, other.fd_);
+    std::swap(mapping_, other.mapping_);
+    std::swap(mapping_size_, other.mapping_size_);
+  }
+
+  Iterator begin() noexcept {
+    return Data();
+  }
+
+  Iterator end() noexcept {
+    return Data() + GetSize();
+  }
+
+  ConstIterator begin() const noexcept {
+    return Data();
+  }
+
+  ConstIterator end() const noexcept {
+    return Data() + GetSize();
+  }
+
+  ConstIterator cbegin() const noexcept {
+    return begin();
+  }
+
+  ConstIterator cend() const noexcept {
+    return end();
+  }
+
+ private:
+  static size_t PageRound(size_t bytes) {
+    static const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return (bytes + page_size - 1) / page_size * page_size;
+  }
+
+  [[noreturn]] void ThrowSystemError(const char *operation) const {
+    throw std::system_error(errno, std::generic_category(), std::string(operation) + " " + path_);
+  }
+
+  detail::FileHeader &GetHeader() noexcept {
+    return *static_cast<detail::FileHeader *>(mapping_);
+  }
+
+  const detail::FileHeader &GetHeader() const noexcept {
+    return *static_cast<const detail::FileHeader *>(mapping_);
+  }
+
+  Type *Data() noexcept {
+    return mapping_ ? reinterpret_cast<Type *>(static_cast<char *>(mapping_) + sizeof(detail::FileHeader)) : nullptr;
+  }
+
+  const Type *Data() const noexcept {
+    return const_cast<MappedVector *>(this)->Data();
+  }
+
+  void SetSize(size_t size) noexcept {
+    if (mapping_) {
+      GetHeader().size = size;
+    }
+  }
+
+  size_t CalculateCapacity(size_t new_size) const noexcept {
+    return GrowthPolicy::NextCapacity(GetCapacity(), new_size, sizeof(Type));
+  }
+
+  void Map(size_t bytes) {
+    void *mapping = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+      ThrowSystemError("mmap");
+    }
+    mapping_ = mapping;
+    mapping_size_ = bytes;
+  }
+
+  // Изменяет размер файла и его отображения до bytes байт.
+  // Файл увеличивается до расширения отображения и уменьшается после его сужения,
+  // чтобы отображение никогда не выходило за конец файла
+  void ResizeFile(size_t bytes) {
+    const size_t old_bytes = mapping_size_;
+    if (bytes > old_bytes && ::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+      ThrowSystemError("ftruncate");
+    }
+    if (!mapping_) {
+      Map(bytes);
+    } else {
+#ifdef MREMAP_MAYMOVE
+      void *mapping = ::mremap(mapping_, mapping_size_, bytes, MREMAP_MAYMOVE);
+      if (mapping == MAP_FAILED) {
+        ThrowSystemError("mremap");
+      }
+      mapping_ = mapping;
+      mapping_size_ = bytes;
+#else
+      ::munmap(mapping_, mapping_size_);
+      mapping_ = nullptr;
+      Map(bytes);
+#endif
+    }
+    if (bytes < old_bytes && ::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+      ThrowSystemError("ftruncate");
+    }
+  }
+
+  void Close() noexcept {
+    if (mapping_) {
+      ::munmap(mapping_, mapping_size_);
+      mapping_ = nullptr;
+      mapping_size_ = 0;
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  std::string path_;
+  int fd_ = -1;
+  void *mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+};
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "config.h"
+
+// Алгоритмы работы с неинициализированной памятью, которые создают
+// и разрушают объекты через std::allocator_traits. В отличие от
+// std::uninitialized_*, они учитывают allocator::construct, что нужно,
+// например, для std::pmr::polymorphic_allocator
+namespace detail {
+
+template<typename Allocator, typename Type, typename = void>
+struct HasCustomConstruct : std::false_type {
+};
+
+template<typename Allocator, typename Type>
+struct HasCustomConstruct<Allocator, Type, std::void_t<decltype(std::declval<Allocator &>().construct(
+    std::declval<Type *>(), std::declval<const Type &>()))>> : std::true_type {
+};
+
+template<typename Allocator, typename Type, typename = void>
+struct HasCustomDestroy : std::false_type {
+};
+
+template<typename Allocator, typename Type>
+struct HasCustomDestroy<Allocator, Type, std::void_t<decltype(std::declval<Allocator &>().destroy(
+    std::declval<Type *>()))>> : std::true_type {
+};
+
+template<typename Iterator>
+using IteratorCategory = typename std::iterator_traits<Iterator>::iterator_category;
+
+// Отключает перегрузку, если Iterator не является итератором ввода
+template<typename Iterator>
+using RequireInputIterator = std::enable_if_t<
+    std::is_convertible_v<IteratorCategory<Iterator>, std::input_iterator_tag>>;
+
+// По диапазону, заданному итераторами Iterator, можно пройти несколько раз
+// и заранее узнать его длину
+template<typename Iterator>
+inline constexpr bool kIsForwardIterator =
+    std::is_convertible_v<IteratorCategory<Iterator>, std::forward_iterator_tag>;
+
+// Стандартные аллокаторы создают и разрушают объекты так же, как placement new и
+// вызов деструктора (polymorphic_allocator - если Type не использует аллокатор)
+template<typename Allocator, typename Type>
+inline constexpr bool kIsPlainAllocator = std::is_same_v<Allocator, std::allocator<Type>>
+    || (std::is_same_v<Allocator, std::pmr::polymorphic_allocator<Type>> && !std::uses_allocator_v<Type, Allocator>);
+
+// Объекты можно создавать копированием байтов (memcpy) в обход allocator::construct
+template<typename Allocator, typename Type>
+inline constexpr bool kCanCopyBitwise = std::conjunction_v<
+    std::is_trivially_copyable<Type>,
+    std::disjunction<std::bool_constant<kIsPlainAllocator<Allocator, Type>>,
+                     std::negation<HasCustomConstruct<Allocator, Type>>>>;
+
+// Объекты можно не разрушать: деструктор тривиален, и allocator::destroy не переопределён
+template<typename Allocator, typename Type>
+inline constexpr bool kCanSkipDestroy = std::conjunction_v<
+    std::is_trivially_destructible<Type>,
+    std::disjunction<std::bool_constant<kIsPlainAllocator<Allocator, Type>>,
+                     std::negation<HasCustomDestroy<Allocator, Type>>>>;
+
+// Разрушает объекты в диапазоне [first, last)
+template<typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void Destroy(Allocator &alloc, Type *first, Type *last) noexcept {
+  if constexpr (!kCanSkipDestroy<Allocator, Type>) {
+    for (; first != last; ++first) {
+      std::allocator_traits<Allocator>::destroy(alloc, first);
+    }
+  }
+}
+
+// Разрушает уже созданные объекты, если конструирование диапазона
+// прервалось исключением
+template<typename Allocator, typename Type>
+class ConstructionGuard {
+ public:
+  SIMPLE_VECTOR_CONSTEXPR ConstructionGuard(Allocator &alloc, Type *first) noexcept
+      : alloc_(alloc), first_(first), current_(first) {
+  }
+
+  // Берёт под охрану уже созданные объекты [first, current)
+  SIMPLE_VECTOR_CONSTEXPR ConstructionGuard(Allocator &alloc, Type *first, Type *current) noexcept
+      : alloc_(alloc), first_(first), current_(current) {
+  }
+
+  ConstructionGuard(const ConstructionGuard &) = delete;
+  ConstructionGuard &operator=(const ConstructionGuard &) = delete;
+
+  SIMPLE_VECTOR_CONSTEXPR ~ConstructionGuard() {
+    if (first_) {
+      Destroy(alloc_, first_, current_);
+    }
+  }
+
+  // Адрес следующего объекта, который нужно создать
+  SIMPLE_VECTOR_CONSTEXPR Type *Current() const noexcept {
+    return current_;
+  }
+
+  // Отмечает очередной объект как созданный
+  SIMPLE_VECTOR_CONSTEXPR void Advance() noexcept {
+    ++current_;
+  }
+
+  // Отменяет разрушение созданных объектов, возвращает адрес за последним из них
+  SIMPLE_VECTOR_CONSTEXPR Type *Release() noexcept {
+    first_ = nullptr;
+    return current_;
+  }
+
+ private:
+  Allocator &alloc_;
+  Type *first_;
+  Type *current_;
+};
+
+// Создаёт в [first, last) объекты, инициализированные значением по умолчанию
+template<typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void UninitializedValueConstruct(Allocator &alloc, Type *first, Type *last) {
+  ConstructionGuard guard(alloc, first);
+  for (; guard.Current() != last; guard.Advance()) {
+    std::allocator_traits<Allocator>::construct(alloc, guard.Current());
+  }
+  guard.Release();
+}
+
+// Создаёт в [first, last) объекты, инициализированные по умолчанию (как `new Type`):
+// память под объекты тривиальных типов остаётся нетронутой.
+// Если аллокатор переопределяет construct, объекты создаются через него со значением
+// по умолчанию, как и при вычислении во время компиляции, где неинициализированные
+// объекты читать нельзя
+template<typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void UninitializedDefaultConstruct(Allocator &alloc, Type *first, Type *last) {
+  if constexpr (kIsPlainAllocator<Allocator, Type> || !HasCustomConstruct<Allocator, Type>::value) {
+    if (!IsConstantEvaluated()) {
+      ConstructionGuard guard(alloc, first);
+      for (; guard.Current() != last; guard.Advance()) {
+        ::new(static_cast<void *>(guard.Current())) Type;
+      }
+      guard.Release();
+      return;
+    }
+  }
+  UninitializedValueConstruct(alloc, first, last);
+}
+
+// Создаёт в [first, last) копии значения value
+template<typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR void UninitializedFill(Allocator &alloc, Type *first, Type *last, const Type &value) {
+  ConstructionGuard guard(alloc, first);
+  for (; guard.Current() != last; guard.Advance()) {
+    std::allocator_traits<Allocator>::construct(alloc, guard.Current(), value);
+  }
+  guard.Release();
+}
+
+// Создаёт начиная с dest копии элементов [first, last).
+// Возвращает адрес за последним созданным объектом
+template<typename Allocator, typename InputIt, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type *UninitializedCopy(Allocator &alloc, InputIt first, InputIt last, Type *dest) {
+  if constexpr (std::is_pointer_v<InputIt>
+      && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<InputIt>>, Type>
+      && kCanCopyBitwise<Allocator, Type>) {
+    // memcpy недоступен при вычислении во время компиляции
+    if (!IsConstantEvaluated()) {
+      const size_t count = last - first;
+      if (count != 0) {
+        std::memcpy(dest, first, count * sizeof(Type));
+      }
+      return dest + count;
+    }
+  }
+  ConstructionGuard guard(alloc, dest);
+  for (; first != last; ++first, guard.Advance()) {
+    std::allocator_traits<Allocator>::construct(alloc, guard.Current(), *first);
+  }
+  return guard.Release();
+}
+
+// Перемещает элементы [first, last) в неинициализированную память начиная с dest.
+// Возвращает адрес за последним созданным объектом
+template<typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type *UninitializedMove(Allocator &alloc, Type *first, Type *last, Type *dest) {
+  if constexpr (kCanCopyBitwise<Allocator, Type>) {
+    return UninitializedCopy(alloc, static_cast<const Type *>(first), static_cast<const Type *>(last), dest);
+  } else {
+    return UninitializedCopy(alloc, std::make_move_iterator(first), std::make_move_iterator(last), dest);
+  }
+}
+
+// При перевыделении памяти элементы копируются, а не перемещаются:
+// перемещение может бросить исключение, а копирование возможно
+template<typename Type>
+inline constexpr bool kRelocatesByCopy =
+    !std::is_nothrow_move_constructible_v<Type> && std::is_copy_constructible_v<Type>;
+
+// Переносит элементы [first, last) в неинициализированную память начиная с dest
+// при перевыделении памяти. Как и std::move_if_noexcept, перемещает элементы, только
+// если перемещение не бросает исключений (или копирование невозможно), иначе копирует их.
+// Поэтому, если перенос прервался исключением, исходные элементы остаются нетронутыми.
+// Тривиально копируемые элементы переносятся одним memcpy.
+// Возвращает адрес за последним созданным объектом
+template<typename Allocator, typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type *UninitializedRelocate(Allocator &alloc, Type *first, Type *last, Type *dest) {
+  if constexpr (kRelocatesByCopy<Type>) {
+    return UninitializedCopy(alloc, static_cast<const Type *>(first), static_cast<const Type *>(last), dest);
+  } else {
+    return UninitializedMove(alloc, first, last, dest);
+  }
+}
+
+// Перемещает присваиванием элементы [first, last) в диапазон, начинающийся с dest.
+// Диапазоны могут перекрываться, если dest <= first
+template<typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type *MoveForward(Type *first, Type *last, Type *dest) {
+  if constexpr (std::is_trivially_copyable_v<Type>) {
+    if (!IsConstantEvaluated()) {
+      const size_t count = last - first;
+      if (count != 0) {
+        std::memmove(dest, first, count * sizeof(Type));
+      }
+      return dest + count;
+    }
+  }
+  return std::move(first, last, dest);
+}
+
+// Перемещает присваиванием элементы [first, last) в диапазон, заканчивающийся на d_last.
+// Диапазоны могут перекрываться, если d_last >= last
+template<typename Type>
+SIMPLE_VECTOR_CONSTEXPR Type *MoveBackward(Type *first, Type *last, Type *d_last) {
+  if constexpr (std::is_trivially_copyable_v<Type>) {
+    if (!IsConstantEvaluated()) {
+      const size_t count = last - first;
+      if (count != 0) {
+        std::memmove(d_last - count, first, count * sizeof(Type));
+      }
+      return d_last - count;
+    }
+  }
+  return std::move_backward(first, last, d_last);
+}
+
+}  // namespace detail
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "checked_iterator.h"
+#include "memory_utils.h"
+#include "thread_pool.h"
+
+// Параллельные алгоритмы над непрерывными диапазонами [first, last),
+// например над [begin(), end()) у SimpleVector.
+// Диапазон делится на части, которые обрабатываются в потоках ThreadPool.
+// Границы частей выравниваются по кэш-линиям, чтобы соседние потоки
+// не писали в одну и ту же линию (false sharing)
+
+// Настройки деления диапазона на части
+struct ParallelOptions {
+  // Пул потоков; nullptr - общий пул программы ThreadPool::Default()
+  ThreadPool *pool = nullptr;
+  // Наименьшее число элементов в части. Меньшие диапазоны обрабатываются в вызывающем потоке
+  size_t min_chunk_size = 16384;
+  // Число частей на поток пула. Чем их больше, тем ровнее нагрузка при неравной стоимости частей
+  size_t chunks_per_thread = 4;
+};
+
+namespace detail {
+
+inline constexpr size_t kCacheLineSize = 64;
+
+template<typename Container>
+using RequireContainer = decltype(std::declval<Container &>().begin(), std::declval<Container &>().end());
+
+inline ThreadPool &GetPool(const ParallelOptions &options) {
+  return options.pool ? *options.pool : ThreadPool::Default();
+}
+
+// Делит [first, last) на части и возвращает их границы: first, ..., last.
+// Размер части кратен числу элементов, занимающих целое число кэш-линий,
+// а первая часть дополнена элементами до начала кэш-линии, чтобы остальные
+// границы попадали на начало линии
+template<typename Type>
+std::vector<Type *> SplitIntoChunks(Type *first, Type *last, const ParallelOptions &options) {
+  const size_t count = last - first;
+  const size_t line_elements = std::lcm(sizeof(Type), kCacheLineSize) / sizeof(Type);
+  const size_t target_chunks = std::max<size_t>(GetPool(options).GetThreadCount() * options.chunks_per_thread, 1);
+  size_t chunk_size = std::max(options.min_chunk_size, (count + target_chunks - 1) / target_chunks);
+  chunk_size = std::max<size_t>((chunk_size + line_elements - 1) / line_elements * line_elements, 1);
+
+  // Сколько элементов до первой границы кэш-линии (если элементы вообще на неё попадают)
+  const size_t misalignment = reinterpret_cast<std::uintptr_t>(first) % kCacheLineSize;
+  size_t head = 0;
+  if (misalignment != 0 && (kCacheLineSize - misalignment) % sizeof(Type) == 0) {
+    head = (kCacheLineSize - misalignment) / sizeof(Type);
+  }
+
+  std::vector<Type *> boundaries{first};
+  size_t offset = head + chunk_size;
+  for (; offset < count; offset += chunk_size) {
+    boundaries.push_back(first + offset);
+  }
+  boundaries.push_back(last);
+  return boundaries;
+}
+
+// Вызывает function(chunk_first, chunk_last) для каждой части [first, last) в потоках пула
+template<typename Type, typename Function>
+void ForEachChunk(Type *first, Type *last, const ParallelOptions &options, Function function) {
+  if (first == last) {
+    return;
+  }
+  const auto boundaries = SplitIntoChunks(first, last, options);
+  ParallelFor(GetPool(options), boundaries.size() - 1, 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      function(boundaries[i], boundaries[i + 1]);
+    }
+  });
+}
+
+// Создаёт объекты в неинициализированной памяти [first, last) по частям в потоках пула:
+// construct(chunk_first, chunk_last) создаёт объекты одной части или, бросив исключение,
+// разрушает созданные в ней. Если исключение бросила хоть одна часть, объекты остальных
+// частей разрушаются, а исключение передаётся дальше.
+// Каждая часть памяти впервые затрагивается создающим её потоком, поэтому
+// страницы распределяются по узлам NUMA, на которых работают потоки пула
+template<typename Allocator, typename Type, typename Construct>
+void ParallelConstruct(Allocator &alloc, Type *first, Type *last, const ParallelOptions &options,
+                       Construct construct) {
+  if (first == last) {
+    return;
+  }
+  const auto boundaries = SplitIntoChunks(first, last, options);
+  std::vector<char> constructed(boundaries.size() - 1, false);
+  try {
+    ParallelFor(GetPool(options), constructed.size(), 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        construct(boundaries[i], boundaries[i + 1]);
+        constructed[i] = true;
+      }
+    });
+  } catch (...) {
+    for (size_t i = 0; i < constructed.size(); ++i) {
+      if (constructed[i]) {
+        Destroy(alloc, boundaries[i], boundaries[i + 1]);
+      }
+    }
+    throw;
+  }
+}
+
+// Частичный результат одной части; занимает отдельную кэш-линию
+template<typename T>
+struct alignas(kCacheLineSize) CacheLinePadded {
+  T value;
+};
+
+}  // namespace detail
+
+// Вызывает function(element) для каждого элемента [first, last)
+template<typename Type, typename Function>
+void ParallelForEach(Type *first, Type *last, Function function, const ParallelOptions &options = {}) {
+  detail::ForEachChunk(first, last, options, [&function](Type *chunk_first, Type *chunk_last) {
+    std::for_each(chunk_first, chunk_last, function);
+  });
+}
+
+template<typename Container, typename Function, typename = detail::RequireContainer<Container>>
+void ParallelForEach(Container &container, Function function, const ParallelOptions &options = {}) {
+  ParallelForEach(detail::ToAddress(container.begin()), detail::ToAddress(container.end()), std::move(function),
+                  options);
+}
+
+// Записывает op(element) для каждого элемента [first, last) в диапазон, начинающийся с dest.
+// Границы частей выравниваются по диапазону назначения, в который идёт запись.
+// Возвращает указатель за последним записанным элементом
+template<typename Type, typename Result, typename UnaryOp>
+Result *ParallelTransform(const Type *first, const Type *last, Result *dest, UnaryOp op,
+                          const ParallelOptions &options = {}) {
+  const size_t count = last - first;
+  detail::ForEachChunk(dest, dest + count, options, [&](Result *chunk_first, Result *chunk_last) {
+    std::transform(first + (chunk_first - dest), first + (chunk_last - dest), chunk_first, op);
+  });
+  return dest + count;
+}
+
+// Сворачивает элементы [first, last) и init операцией op.
+// Части сворачиваются параллельно, а их результаты - по порядку частей,
+// поэтому op должна быть ассоциативной. T должен создаваться из Type
+template<typename Type, typename T, typename BinaryOp = std::plus<>>
+T ParallelReduce(const Type *first, const Type *last, T init, BinaryOp op = {}, const ParallelOptions &options = {}) {
+  if (first == last) {
+    return init;
+  }
+  const auto boundaries = detail::SplitIntoChunks(first, last, options);
+  std::vector<detail::CacheLinePadded<T>> partial(boundaries.size() - 1, {init});
+  ParallelFor(detail::GetPool(options), partial.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      partial[i].value = std::accumulate(boundaries[i] + 1, boundaries[i + 1], T(*boundaries[i]), op);
+    }
+  });
+  for (auto &chunk : partial) {
+    init = op(std::move(init), std::move(chunk.value));
+  }
+  return init;
+}
+
+template<typename Container, typename T, typename BinaryOp = std::plus<>,
+    typename = detail::RequireContainer<const Container>>
+T ParallelReduce(const Container &container, T init, BinaryOp op = {}, const ParallelOptions &options = {}) {
+  return ParallelReduce(detail::ToAddress(container.begin()), detail::ToAddress(container.end()), std::move(init),
+                        std::move(op), options);
+}
+
+// Присваивает всем элементам [first, last) значение value
+template<typename Type>
+void ParallelFill(Type *first, Type *last, const Type &value, const ParallelOptions &options = {}) {
+  detail::ForEachChunk(first, last, options, [&value](Type *chunk_first, Type *chunk_last) {
+    std::fill(chunk_first, chunk_last, value);
+  });
+}
+
+template<typename Container, typename Type, typename = detail::RequireContainer<Container>>
+void ParallelFill(Container &container, const Type &value, const ParallelOptions &options = {}) {
+  ParallelFill(detail::ToAddress(container.begin()), detail::ToAddress(container.end()), value, options);
+}
+
+// Сортирует [first, last): части сортируются параллельно, затем соседние
+// отсортированные отрезки попарно сливаются, пока не останется один
+template<typename Type, typename Compare = std::less<>>
+void ParallelSort(Type *first, Type *last, Compare comp = {}, const ParallelOptions &options = {}) {
+  if (first == last) {
+    return;
+  }
+  auto runs = detail::SplitIntoChunks(first, last, options);
+  auto &pool = detail::GetPool(options);
+  ParallelFor(pool, runs.size() - 1, 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      std::sort(runs[i], runs[i + 1], comp);
+    }
+  });
+  while (runs.size() > 2) {
+    const size_t pairs = (runs.size() - 1) / 2;
+    ParallelFor(pool, pairs, 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        std::inplace_merge(runs[2 * i], runs[2 * i + 1], runs[2 * i + 2], comp);
+      }
+    });
+    // Оставляем границы слитых отрезков и, если число отрезков нечётно, последний отрезок
+    std::vector<Type *> merged;
+    for (size_t i = 0; i < runs.size(); i += 2) {
+      merged.push_back(runs[i]);
+    }
+    if (merged.back() != last) {
+      merged.push_back(last);
+    }
+    runs = std::move(merged);
+  }
+}
+
+template<typename Container, typename Compare = std::less<>, typename = detail::RequireContainer<Container>>
+void ParallelSort(Container &container, Compare comp = {}, const ParallelOptions &options = {}) {
+  ParallelSort(detail::ToAddress(container.begin()), detail::ToAddress(container.end()), std::move(comp), options);
+}
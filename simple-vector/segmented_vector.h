@@ -0,0 +1,663 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "checked_iterator.h"
+#include "memory_utils.h"
+#include "simd_compare.h"
+#include "simple_span.h"
+#include "simple_vector.h"
+
+namespace detail {
+
+constexpr size_t FloorPowerOfTwo(size_t value) noexcept {
+  size_t result = 1;
+  while (result <= value / 2) {
+    result *= 2;
+  }
+  return result;
+}
+
+// Число элементов в блоке по умолчанию: степень двойки, при которой блок занимает около 64 КиБ
+template<typename Type>
+inline constexpr size_t kDefaultChunkSize = FloorPowerOfTwo(std::max<size_t>(1, (size_t{1} << 16) / sizeof(Type)));
+
+// Итератор SegmentedVector: каталог блоков и номер элемента.
+// Становится недействительным, когда перевыделяется каталог (при выделении новых блоков)
+template<typename Type, size_t ChunkSize>
+class SegmentedIterator {
+  using Chunks = std::remove_const_t<Type> *const *;
+
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_cv_t<Type>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = Type *;
+  using reference = Type &;
+
+  SegmentedIterator() noexcept = default;
+
+  SegmentedIterator(Chunks chunks, size_t index) noexcept : chunks_(chunks), index_(index) {
+  }
+
+  // Iterator приводится к ConstIterator
+  template<typename Other, typename = std::enable_if_t<std::is_convertible_v<Other *, Type *>>>
+  SegmentedIterator(const SegmentedIterator<Other, ChunkSize> &other) noexcept
+      : chunks_(other.chunks_), index_(other.index_) {
+  }
+
+  // Номер элемента в векторе
+  size_t GetIndex() const noexcept {
+    return index_;
+  }
+
+  Type &operator*() const noexcept {
+    return chunks_[index_ / ChunkSize][index_ % ChunkSize];
+  }
+
+  Type *operator->() const noexcept {
+    return &**this;
+  }
+
+  Type &operator[](difference_type offset) const noexcept {
+    return *(*this + offset);
+  }
+
+  SegmentedIterator &operator++() noexcept {
+    ++index_;
+    return *this;
+  }
+
+  SegmentedIterator operator++(int) noexcept {
+    SegmentedIterator old = *this;
+    ++index_;
+    return old;
+  }
+
+  SegmentedIterator &operator--() noexcept {
+    --index_;
+    return *this;
+  }
+
+  SegmentedIterator operator--(int) noexcept {
+    SegmentedIterator old = *this;
+    --index_;
+    return old;
+  }
+
+  SegmentedIterator &operator+=(difference_type offset) noexcept {
+    index_ += offset;
+    return *this;
+  }
+
+  SegmentedIterator &operator-=(difference_type offset) noexcept {
+    index_ -= offset;
+    return *this;
+  }
+
+  friend SegmentedIterator operator+(SegmentedIterator it, difference_type offset) noexcept {
+    return it += offset;
+  }
+
+  friend SegmentedIterator operator+(difference_type offset, SegmentedIterator it) noexcept {
+    return it += offset;
+  }
+
+  friend SegmentedIterator operator-(SegmentedIterator it, difference_type offset) noexcept {
+    return it -= offset;
+  }
+
+ private:
+  template<typename, size_t>
+  friend class SegmentedIterator;
+
+  Chunks chunks_ = nullptr;
+  size_t index_ = 0;
+};
+
+template<typename Type, typename Other, size_t ChunkSize>
+std::ptrdiff_t operator-(const SegmentedIterator<Type, ChunkSize> &lhs,
+                         const SegmentedIterator<Other, ChunkSize> &rhs) noexcept {
+  return static_cast<std::ptrdiff_t>(lhs.GetIndex() - rhs.GetIndex());
+}
+
+template<typename Type, typename Other, size_t ChunkSize>
+bool operator==(const SegmentedIterator<Type, ChunkSize> &lhs, const SegmentedIterator<Other, ChunkSize> &rhs) noexcept {
+  return lhs.GetIndex() == rhs.GetIndex();
+}
+
+template<typename Type, typename Other, size_t ChunkSize>
+bool operator!=(const SegmentedIterator<Type, ChunkSize> &lhs, const SegmentedIterator<Other, ChunkSize> &rhs) noexcept {
+  return !(lhs == rhs);
+}
+
+template<typename Type, typename Other, size_t ChunkSize>
+bool operator<(const SegmentedIterator<Type, ChunkSize> &lhs, const SegmentedIterator<Other, ChunkSize> &rhs) noexcept {
+  return lhs.GetIndex() < rhs.GetIndex();
+}
+
+template<typename Type, typename Other, size_t ChunkSize>
+bool operator<=(const SegmentedIterator<Type, ChunkSize> &lhs, const SegmentedIterator<Other, ChunkSize> &rhs) noexcept {
+  return !(rhs < lhs);
+}
+
+template<typename Type, typename Other, size_t ChunkSize>
+bool operator>(const SegmentedIterator<Type, ChunkSize> &lhs, const SegmentedIterator<Other, ChunkSize> &rhs) noexcept {
+  return rhs < lhs;
+}
+
+template<typename Type, typename Other, size_t ChunkSize>
+bool operator>=(const SegmentedIterator<Type, ChunkSize> &lhs, const SegmentedIterator<Other, ChunkSize> &rhs) noexcept {
+  return !(lhs < rhs);
+}
+
+}  // namespace detail
+
+// Вектор, элементы которого хранятся в блоках по ChunkSize элементов.
+// Адреса блоков лежат в каталоге (SimpleVector указателей), поэтому operator[] -
+// это одно обращение к каталогу, сдвиг и маска.
+// При росте выделяется новый блок, а существующие элементы не переносятся:
+// ссылки и указатели на элементы остаются действительными до их удаления,
+// а добавление в конец не копирует данные и не требует памяти сверх одного блока.
+// Перевыделяется только каталог, и при этом копируются лишь указатели на блоки;
+// итераторы после этого становятся недействительными, как у std::deque.
+// Вставка и удаление в середине сдвигают элементы, как у SimpleVector.
+// Элементы непрерывны только внутри блока (см. GetChunk)
+template<typename Type, size_t ChunkSize = detail::kDefaultChunkSize<Type>, typename Allocator = std::allocator<Type>>
+class SegmentedVector {
+  static_assert(ChunkSize != 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of two");
+
+  using AllocTraits = std::allocator_traits<Allocator>;
+  using DirectoryAllocator = typename AllocTraits::template rebind_alloc<Type *>;
+  using Directory = SimpleVector<Type *, DirectoryAllocator>;
+
+ public:
+  using Iterator = detail::SegmentedIterator<Type, ChunkSize>;
+  using ConstIterator = detail::SegmentedIterator<const Type, ChunkSize>;
+  using AllocatorType = Allocator;
+
+  static constexpr size_t kChunkSize = ChunkSize;
+
+  SegmentedVector() noexcept(noexcept(Allocator())) = default;
+
+  explicit SegmentedVector(const Allocator &alloc) noexcept : alloc_(alloc), chunks_(DirectoryAllocator(alloc)) {
+  }
+
+  // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+  explicit SegmentedVector(size_t size, const Allocator &alloc = Allocator()) : SegmentedVector(alloc) {
+    Resize(size);
+  }
+
+  // Создаёт вектор из size элементов, инициализированных значением value
+  SegmentedVector(size_t size, const Type &value, const Allocator &alloc = Allocator()) : SegmentedVector(alloc) {
+    AppendFill(size, value);
+  }
+
+  // Создаёт вектор из std::initializer_list
+  SegmentedVector(std::initializer_list<Type> init, const Allocator &alloc = Allocator()) : SegmentedVector(alloc) {
+    Append(init.begin(), init.end());
+  }
+
+  SegmentedVector(const SegmentedVector &other)
+      : SegmentedVector(other, AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+  }
+
+  // Создаёт копию other, память для которой выделяется аллокатором alloc.
+  // Блоки копии выровнены так же, как блоки other, и копируются целиком
+  SegmentedVector(const SegmentedVector &other, const Allocator &alloc) : SegmentedVector(alloc) {
+    GrowBy(other.size_, [&](Allocator &construct_alloc, Type *first, Type *last, size_t index) {
+      const Type *source = other.ElementAddress(index);
+      detail::UninitializedCopy(construct_alloc, source, source + (last - first), first);
+    });
+  }
+
+  SegmentedVector(SegmentedVector &&other) noexcept
+      : alloc_(std::move(other.alloc_)),
+        chunks_(std::move(other.chunks_)),
+        size_(std::exchange(other.size_, 0)) {
+  }
+
+  ~SegmentedVector() {
+    Reset();
+  }
+
+  // Аллокатор заменяется аллокатором rhs, только если этого требует
+  // propagate_on_container_copy_assignment
+  SegmentedVector &operator=(const SegmentedVector &rhs) {
+    if (this == &rhs) {
+      return *this;
+    }
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+      if (alloc_ != rhs.alloc_) {
+        Reset();
+        alloc_ = rhs.alloc_;
+        chunks_ = Directory(DirectoryAllocator(alloc_));
+      }
+    }
+    SegmentedVector copy(rhs, alloc_);
+    swap(copy);
+    return *this;
+  }
+
+  // Если аллокатор не передаётся (propagate_on_container_move_assignment == false)
+  // и аллокаторы не равны, забрать блоки rhs нельзя, и элементы перемещаются по одному
+  SegmentedVector &operator=(SegmentedVector &&rhs) noexcept(
+      AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+    if (this == &rhs) {
+      return *this;
+    }
+    if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+        && !AllocTraits::is_always_equal::value) {
+      if (alloc_ != rhs.alloc_) {
+        Clear();
+        GrowBy(rhs.size_, [&](Allocator &alloc, Type *first, Type *last, size_t index) {
+          Type *source = rhs.ElementAddress(index);
+          detail::UninitializedMove(alloc, source, source + (last - first), first);
+        });
+        rhs.Clear();
+        return *this;
+      }
+    }
+    Reset();
+    if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+      alloc_ = std::move(rhs.alloc_);
+    }
+    chunks_ = std::move(rhs.chunks_);
+    size_ = std::exchange(rhs.size_, 0);
+    return *this;
+  }
+
+  // Возвращает копию аллокатора вектора
+  Allocator GetAllocator() const noexcept {
+    return alloc_;
+  }
+
+  // Возвращает количество элементов в векторе
+  size_t GetSize() const noexcept {
+    return size_;
+  }
+
+  // Возвращает вместимость вектора: число элементов в выделенных блоках
+  size_t GetCapacity() const noexcept {
+    return chunks_.GetSize() * ChunkSize;
+  }
+
+  // Сообщает, пустой ли вектор
+  bool IsEmpty() const noexcept {
+    return size_ == 0;
+  }
+
+  // Возвращает число блоков, в которых лежат элементы
+  size_t GetChunkCount() const noexcept {
+    return (size_ + ChunkSize - 1) / ChunkSize;
+  }
+
+  // Возвращает элементы блока с номером chunk. Все блоки, кроме последнего, заполнены целиком
+  SimpleSpan<Type> GetChunk(size_t chunk) noexcept {
+    assert(chunk < GetChunkCount());
+    return SimpleSpan<Type>(chunks_.Data()[chunk], std::min(ChunkSize, size_ - chunk * ChunkSize));
+  }
+
+  SimpleSpan<const Type> GetChunk(size_t chunk) const noexcept {
+    assert(chunk < GetChunkCount());
+    return SimpleSpan<const Type>(chunks_.Data()[chunk], std::min(ChunkSize, size_ - chunk * ChunkSize));
+  }
+
+  // Возвращает ссылку на элемент с индексом index
+  Type &operator[](size_t index) SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(index < size_, "index is out of range");
+    return *ElementAddress(index);
+  }
+
+  // Возвращает константную ссылку на элемент с индексом index
+  const Type &operator[](size_t index) const SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(index < size_, "index is out of range");
+    return *ElementAddress(index);
+  }
+
+  // Возвращает ссылку на элемент с индексом index
+  // Выбрасывает исключение std::out_of_range, если index >= size
+  Type &At(size_t index) {
+    if (index >= size_) {
+      throw std::out_of_range("out_of_range");
+    }
+    return *ElementAddress(index);
+  }
+
+  // Возвращает константную ссылку на элемент с индексом index
+  // Выбрасывает исключение std::out_of_range, если index >= size
+  const Type &At(size_t index) const {
+    if (index >= size_) {
+      throw std::out_of_range("out_of_range");
+    }
+    return *ElementAddress(index);
+  }
+
+  // Разрушает все элементы и обнуляет размер вектора, не освобождая блоки
+  void Clear() noexcept {
+    DestroyRange(0, size_);
+    size_ = 0;
+  }
+
+  // Изменяет размер вектора.
+  // При уменьшении размера лишние элементы разрушаются.
+  // При увеличении размера новые элементы получают значение по умолчанию для типа Type
+  void Resize(size_t new_size) {
+    if (new_size < size_) {
+      DestroyRange(new_size, size_);
+      size_ = new_size;
+      return;
+    }
+    GrowBy(new_size - size_, [](Allocator &alloc, Type *first, Type *last, size_t) {
+      detail::UninitializedValueConstruct(alloc, first, last);
+    });
+  }
+
+  // Добавляет элемент в конец вектора.
+  // При нехватке места выделяет ещё один блок
+  void PushBack(const Type &item) {
+    EmplaceBack(item);
+  }
+
+  void PushBack(Type &&item) {
+    EmplaceBack(std::move(item));
+  }
+
+  // Создаёт элемент из аргументов args прямо в конце вектора.
+  // Возвращает ссылку на созданный элемент.
+  // Элементы не переносятся, поэтому args могут ссылаться на элементы вектора
+  template<typename... Args>
+  Type &EmplaceBack(Args &&... args) {
+    if (size_ == GetCapacity()) {
+      AllocateChunks(chunks_.GetSize() + 1);
+    }
+    Type *const slot = ElementAddress(size_);
+    AllocTraits::construct(alloc_, slot, std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+  }
+
+  // Вставляет значение value в позицию pos.
+  // Возвращает итератор на вставленное значение
+  Iterator Insert(ConstIterator pos, const Type &value) {
+    return Emplace(pos, value);
+  }
+
+  Iterator Insert(ConstIterator pos, Type &&value) {
+    return Emplace(pos, std::move(value));
+  }
+
+  // Создаёт элемент из аргументов args в позиции pos.
+  // Возвращает итератор на созданный элемент.
+  // Элементы после pos сдвигаются на одну позицию
+  template<typename... Args>
+  Iterator Emplace(ConstIterator pos, Args &&... args) {
+    const size_t index = IndexOf(pos);
+    if (index == size_) {
+      EmplaceBack(std::forward<Args>(args)...);
+    } else {
+      Type temp(std::forward<Args>(args)...);
+      EmplaceBack(std::move(*ElementAddress(size_ - 1)));
+      std::move_backward(begin() + index, end() - 2, end() - 1);
+      *ElementAddress(index) = std::move(temp);
+    }
+    return begin() + index;
+  }
+
+  // Вставляет в позицию pos копии элементов [first, last), которые не должны
+  // принадлежать самому вектору. Возвращает итератор на первый вставленный элемент.
+  // Элементы добавляются в конец и затем переставляются на место
+  template<typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+  Iterator Insert(ConstIterator pos, InputIt first, InputIt last) {
+    const size_t index = IndexOf(pos);
+    const size_t old_size = size_;
+    Append(first, last);
+    std::rotate(begin() + index, begin() + old_size, end());
+    return begin() + index;
+  }
+
+  // Вставляет в позицию pos count копий value.
+  // Возвращает итератор на первый вставленный элемент
+  Iterator Insert(ConstIterator pos, size_t count, const Type &value) {
+    const size_t index = IndexOf(pos);
+    const size_t old_size = size_;
+    AppendFill(count, value);
+    std::rotate(begin() + index, begin() + old_size, end());
+    return begin() + index;
+  }
+
+  // Добавляет в конец вектора копии элементов [first, last).
+  // Для однонаправленных итераторов недостающие блоки выделяются заранее,
+  // элементы создаются по блокам, и при исключении вектор остаётся прежним
+  template<typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+  void Append(InputIt first, InputIt last) {
+    if constexpr (detail::kIsForwardIterator<InputIt>) {
+      GrowBy(std::distance(first, last), [&](Allocator &alloc, Type *dest_first, Type *dest_last, size_t) {
+        InputIt next = std::next(first, dest_last - dest_first);
+        detail::UninitializedCopy(alloc, first, next, dest_first);
+        first = next;
+      });
+    } else {
+      for (; first != last; ++first) {
+        EmplaceBack(*first);
+      }
+    }
+  }
+
+  // Заменяет содержимое вектора копиями элементов [first, last)
+  template<typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+  void Assign(InputIt first, InputIt last) {
+    Clear();
+    Append(first, last);
+  }
+
+  // Удаляет последний элемент вектора. Вектор не должен быть пустым
+  void PopBack() SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(!IsEmpty(), "PopBack of empty vector");
+    assert(!IsEmpty());
+    --size_;
+    AllocTraits::destroy(alloc_, ElementAddress(size_));
+  }
+
+  // Удаляет элемент вектора в указанной позиции
+  Iterator Erase(ConstIterator pos) {
+    const size_t index = IndexOf(pos);
+    detail::Check(index < size_, "Erase of end()");
+    assert(index < size_);
+    std::move(begin() + index + 1, end(), begin() + index);
+    PopBack();
+    return begin() + index;
+  }
+
+  // Выделяет блоки так, чтобы в них поместилось не меньше new_capacity элементов.
+  // Существующие элементы не переносятся
+  void Reserve(size_t new_capacity) {
+    AllocateChunks(new_capacity / ChunkSize + (new_capacity % ChunkSize != 0));
+  }
+
+  // Освобождает блоки, в которых нет элементов, и уменьшает каталог
+  void ShrinkToFit() {
+    const size_t used = GetChunkCount();
+    for (size_t chunk = used; chunk < chunks_.GetSize(); ++chunk) {
+      AllocTraits::deallocate(alloc_, chunks_.Data()[chunk], ChunkSize);
+    }
+    chunks_.Resize(used);
+    chunks_.ShrinkToFit();
+  }
+
+  // Разрушает все элементы и освобождает память. Размер и вместимость становятся равны 0
+  void Reset() noexcept {
+    Clear();
+    for (Type *chunk : chunks_) {
+      AllocTraits::deallocate(alloc_, chunk, ChunkSize);
+    }
+    chunks_.Reset();
+  }
+
+  // Обменивает значение с другим вектором.
+  // Аллокаторы обмениваются, только если этого требует propagate_on_container_swap,
+  // иначе они должны быть равны
+  void swap(SegmentedVector &other) noexcept {
+    assert(AllocTraits::propagate_on_container_swap::value || alloc_ == other.alloc_);
+    if constexpr (AllocTraits::propagate_on_container_swap::value) {
+      using std::swap;
+      swap(alloc_, other.alloc_);
+    }
+    chunks_.swap(other.chunks_);
+    std::swap(size_, other.size_);
+  }
+
+  // Возвращает итератор на начало вектора
+  Iterator begin() noexcept {
+    return Iterator(chunks_.Data(), 0);
+  }
+
+  // Возвращает итератор на элемент, следующий за последним
+  Iterator end() noexcept {
+    return Iterator(chunks_.Data(), size_);
+  }
+
+  ConstIterator begin() const noexcept {
+    return ConstIterator(chunks_.Data(), 0);
+  }
+
+  ConstIterator end() const noexcept {
+    return ConstIterator(chunks_.Data(), size_);
+  }
+
+  ConstIterator cbegin() const noexcept {
+    return begin();
+  }
+
+  ConstIterator cend() const noexcept {
+    return end();
+  }
+
+ private:
+  Type *ElementAddress(size_t index) const noexcept {
+    return chunks_.Data()[index / ChunkSize] + index % ChunkSize;
+  }
+
+  // Индекс позиции pos для вставки и удаления
+  size_t IndexOf(ConstIterator pos) const noexcept {
+    assert(pos >= cbegin() && pos <= cend());
+    return pos.GetIndex();
+  }
+
+  // Выделяет блоки, пока их не станет chunk_count. Каталог растёт
+  // по политике SimpleVector, так что добавление по одному блоку
+  // копирует указатели амортизированно O(1) раз
+  void AllocateChunks(size_t chunk_count) {
+    if (chunk_count <= chunks_.GetSize()) {
+      return;
+    }
+    chunks_.Reserve(chunks_.GetGrowthCapacity(chunk_count));
+    while (chunks_.GetSize() < chunk_count) {
+      // После Reserve добавление указателя не бросает исключений
+      chunks_.PushBack(AllocTraits::allocate(alloc_, ChunkSize));
+    }
+  }
+
+  // Создаёт count новых элементов в конце вектора, вызывая для каждого затронутого
+  // блока construct(alloc, first, last, index), где index - номер элемента first.
+  // Недостающие блоки выделяются заранее. Если создание бросает исключение,
+  // созданные элементы разрушаются, и размер вектора остаётся прежним
+  template<typename ConstructFn>
+  void GrowBy(size_t count, ConstructFn construct) {
+    if (count == 0) {
+      return;
+    }
+    Reserve(size_ + count);
+    const size_t old_size = size_;
+    try {
+      while (count != 0) {
+        const size_t step = std::min(count, ChunkSize - size_ % ChunkSize);
+        Type *const first = ElementAddress(size_);
+        construct(alloc_, first, first + step, size_);
+        size_ += step;
+        count -= step;
+      }
+    } catch (...) {
+      DestroyRange(old_size, size_);
+      size_ = old_size;
+      throw;
+    }
+  }
+
+  // Добавляет в конец вектора count копий value
+  void AppendFill(size_t count, const Type &value) {
+    // value может ссылаться на элемент вектора, а при исключении он будет разрушен
+    const Type copy(value);
+    GrowBy(count, [&](Allocator &alloc, Type *first, Type *last, size_t) {
+      detail::UninitializedFill(alloc, first, last, copy);
+    });
+  }
+
+  // Разрушает элементы с номерами [first, last), проходя по блокам
+  void DestroyRange(size_t first, size_t last) noexcept {
+    while (first != last) {
+      const size_t step = std::min(last - first, ChunkSize - first % ChunkSize);
+      Type *const data = ElementAddress(first);
+      detail::Destroy(alloc_, data, data + step);
+      first += step;
+    }
+  }
+
+  [[no_unique_address]] Allocator alloc_;
+  Directory chunks_;
+  size_t size_ = 0;
+};
+
+// Блоки векторов с одинаковым ChunkSize выровнены одинаково и сравниваются целиком
+template<typename Type, size_t ChunkSize, typename Allocator>
+bool operator==(const SegmentedVector<Type, ChunkSize, Allocator> &lhs,
+                const SegmentedVector<Type, ChunkSize, Allocator> &rhs) {
+  if (lhs.GetSize() != rhs.GetSize()) {
+    return false;
+  }
+  for (size_t chunk = 0; chunk < lhs.GetChunkCount(); ++chunk) {
+    const SimpleSpan<const Type> left = lhs.GetChunk(chunk);
+    if (!detail::RangesEqual(left.Data(), rhs.GetChunk(chunk).Data(), left.GetSize())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template<typename Type, size_t ChunkSize, typename Allocator>
+bool operator!=(const SegmentedVector<Type, ChunkSize, Allocator> &lhs,
+                const SegmentedVector<Type, ChunkSize, Allocator> &rhs) {
+  return !(lhs == rhs);
+}
+
+template<typename Type, size_t ChunkSize, typename Allocator>
+bool operator<(const SegmentedVector<Type, ChunkSize, Allocator> &lhs,
+               const SegmentedVector<Type, ChunkSize, Allocator> &rhs) {
+  return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template<typename Type, size_t ChunkSize, typename Allocator>
+bool operator<=(const SegmentedVector<Type, ChunkSize, Allocator> &lhs,
+                const SegmentedVector<Type, ChunkSize, Allocator> &rhs) {
+  return !(rhs < lhs);
+}
+
+template<typename Type, size_t ChunkSize, typename Allocator>
+bool operator>(const SegmentedVector<Type, ChunkSize, Allocator> &lhs,
+               const SegmentedVector<Type, ChunkSize, Allocator> &rhs) {
+  return rhs < lhs;
+}
+
+template<typename Type, size_t ChunkSize, typename Allocator>
+bool operator>=(const SegmentedVector<Type, ChunkSize, Allocator> &lhs,
+                const SegmentedVector<Type, ChunkSize, Allocator> &rhs) {
+  return !(lhs < rhs);
+}
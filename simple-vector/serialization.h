@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "file_header.h"
+#include "simple_span.h"
+
+// Запись векторов в поток или буфер и чтение из них.
+// Формат - заголовок detail::FileHeader и элементы одним блоком, тот же, что и у MappedVector,
+// поэтому записанный файл можно открыть через MappedVector без чтения и копирования.
+// Подходит любой вектор тривиально копируемых элементов с GetSize(), begin(), Clear(),
+// Reserve() и Resize() (или ResizeUninitialized()): SimpleVector, SmallVector, MappedVector
+
+namespace detail {
+
+template<typename Vector>
+using VectorValueType = std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<Vector &>().begin())>>;
+
+template<typename Vector>
+void RequireSerializable() {
+  static_assert(std::is_trivially_copyable_v<VectorValueType<Vector>>,
+                "only vectors of trivially copyable elements can be serialized");
+}
+
+template<typename Vector, typename = void>
+struct HasResizeUninitialized : std::false_type {
+};
+
+template<typename Vector>
+struct HasResizeUninitialized<Vector, std::void_t<decltype(std::declval<Vector &>().ResizeUninitialized(size_t()))>>
+    : std::true_type {
+};
+
+// Изменяет размер v под элементы, которые сразу перезаписываются прочитанными байтами,
+// поэтому, если вектор это позволяет, память под них не обнуляется
+template<typename Vector>
+void ResizeForRead(Vector &v, size_t size) {
+  if constexpr (HasResizeUninitialized<Vector>::value
+      && std::is_trivially_default_constructible_v<VectorValueType<Vector>>) {
+    v.ResizeUninitialized(size);
+  } else {
+    v.Resize(size);
+  }
+}
+
+// Очищает v и резервирует память ровно под size элементов одним выделением
+template<typename Vector>
+void PrepareForRead(Vector &v, size_t size) {
+  v.Clear();
+  v.Reserve(size);
+  ResizeForRead(v, size);
+}
+
+// Возвращает число байт от текущей позиции до конца потока
+// или -1, если поток не поддерживает позиционирование
+inline std::streamoff GetRemainingBytes(std::istream &in) {
+  const std::istream::pos_type position = in.tellg();
+  if (position == std::istream::pos_type(-1)) {
+    in.clear();
+    return -1;
+  }
+  in.seekg(0, std::ios::end);
+  const std::istream::pos_type end = in.fail() ? std::istream::pos_type(-1) : in.tellg();
+  in.clear();
+  in.seekg(position);
+  return end == std::istream::pos_type(-1) ? -1 : std::streamoff(end - position);
+}
+
+// Наибольший блок, на который вектор растёт при чтении из потока неизвестной длины
+inline constexpr size_t kReadChunkBytes = size_t(1) << 20;
+
+}  // namespace detail
+
+// Число байт, которое займёт v после записи
+template<typename Vector>
+size_t SerializedSize(const Vector &v) noexcept {
+  return sizeof(detail::FileHeader) + v.GetSize() * sizeof(detail::VectorValueType<Vector>);
+}
+
+// Записывает v в поток out. Бросает std::runtime_error, если запись не удалась
+template<typename Vector>
+void Serialize(std::ostream &out, const Vector &v) {
+  detail::RequireSerializable<Vector>();
+  const auto header = detail::MakeFileHeader(sizeof(detail::VectorValueType<Vector>), v.GetSize());
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  if (v.GetSize() != 0) {
+    out.write(reinterpret_cast<const char *>(detail::ToAddress(v.begin())),
+              v.GetSize() * sizeof(detail::VectorValueType<Vector>));
+  }
+  if (!out) {
+    throw std::runtime_error("failed to write SimpleVector");
+  }
+}
+
+// Заменяет содержимое v элементами, прочитанными из потока in.
+// Если поток поддерживает позиционирование, память выделяется один раз ровно под элементы,
+// иначе вектор растёт по мере чтения, так что повреждённый заголовок не приводит к огромному выделению.
+// Бросает std::runtime_error, если данные повреждены или не подходят по типу
+template<typename Vector>
+void Deserialize(std::istream &in, Vector &v) {
+  detail::RequireSerializable<Vector>();
+  detail::FileHeader header;
+  if (!in.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    throw std::runtime_error("SimpleVector data is truncated");
+  }
+  constexpr size_t kElementSize = sizeof(detail::VectorValueType<Vector>);
+  detail::ValidateFileHeader(header, kElementSize);
+  // Размер из заголовка не должен приводить к выделению памяти больше, чем есть данных
+  const std::streamoff remaining = detail::GetRemainingBytes(in);
+  if (remaining >= 0) {
+    if (header.size > static_cast<uint64_t>(remaining) / kElementSize) {
+      throw std::runtime_error("SimpleVector data is truncated");
+    }
+    detail::PrepareForRead(v, header.size);
+    if (header.size != 0
+        && !in.read(reinterpret_cast<char *>(detail::ToAddress(v.begin())), header.size * kElementSize)) {
+      v.Clear();
+      throw std::runtime_error("SimpleVector data is truncated");
+    }
+    return;
+  }
+  // Длина потока неизвестна: вектор растёт блоками по мере чтения
+  constexpr size_t kChunkSize = std::max<size_t>(detail::kReadChunkBytes / kElementSize, 1);
+  v.Clear();
+  for (uint64_t left = header.size; left != 0;) {
+    const size_t count = static_cast<size_t>(std::min<uint64_t>(left, kChunkSize));
+    const size_t old_size = v.GetSize();
+    detail::ResizeForRead(v, old_size + count);
+    if (!in.read(reinterpret_cast<char *>(detail::ToAddress(v.begin()) + old_size), count * kElementSize)) {
+      v.Clear();
+      throw std::runtime_error("SimpleVector data is truncated");
+    }
+    left -= count;
+  }
+}
+
+// Записывает v в буфер [buffer, buffer + buffer_size). Возвращает число записанных байт.
+// Бросает std::length_error, если буфер меньше SerializedSize(v)
+template<typename Vector>
+size_t Serialize(unsigned char *buffer, size_t buffer_size, const Vector &v) {
+  detail::RequireSerializable<Vector>();
+  const size_t bytes = SerializedSize(v);
+  if (buffer_size < bytes) {
+    throw std::length_error("buffer is too small for SimpleVector");
+  }
+  const auto header = detail::MakeFileHeader(sizeof(detail::VectorValueType<Vector>), v.GetSize());
+  std::memcpy(buffer, &header, sizeof(header));
+  if (v.GetSize() != 0) {
+    std::memcpy(buffer + sizeof(header), detail::ToAddress(v.begin()), bytes - sizeof(header));
+  }
+  return bytes;
+}
+
+// Заменяет содержимое v элементами из буфера [data, data + size).
+// Возвращает число прочитанных байт
+template<typename Vector>
+size_t Deserialize(const unsigned char *data, size_t size, Vector &v) {
+  detail::RequireSerializable<Vector>();
+  detail::FileHeader header;
+  if (size < sizeof(header)) {
+    throw std::runtime_error("SimpleVector data is truncated");
+  }
+  std::memcpy(&header, data, sizeof(header));
+  detail::ValidateFileHeader(header, sizeof(detail::VectorValueType<Vector>));
+  if (header.size > (size - sizeof(header)) / sizeof(detail::VectorValueType<Vector>)) {
+    throw std::runtime_error("SimpleVector data is truncated");
+  }
+  const size_t bytes = header.size * sizeof(detail::VectorValueType<Vector>);
+  detail::PrepareForRead(v, header.size);
+  if (bytes != 0) {
+    std::memcpy(detail::ToAddress(v.begin()), data + sizeof(header), bytes);
+  }
+  return sizeof(header) + bytes;
+}
+
+// То же для буфера, заданного SimpleSpan
+template<typename Vector>
+size_t Serialize(SimpleSpan<unsigned char> buffer, const Vector &v) {
+  return Serialize(buffer.Data(), buffer.GetSize(), v);
+}
+
+template<typename Vector>
+size_t Deserialize(SimpleSpan<const unsigned char> data, Vector &v) {
+  return Deserialize(data.Data(), data.GetSize(), v);
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "config.h"
+
+// Сравнение непрерывных диапазонов для операторов сравнения векторов.
+// Для целых чисел, перечислений и указателей равенство элементов совпадает
+// с равенством их байтов. Поэтому равенство проверяется через memcmp, а первое различие
+// для лексикографического сравнения ищется сразу по 16-32 байта (AVX2, SSE2 или NEON,
+// в зависимости от флагов компиляции), а без них - тоже через memcmp.
+// Во время компиляции используются обычные std::equal и std::lexicographical_compare
+namespace detail {
+
+// Элементы равны тогда и только тогда, когда равны их байты.
+// Числа с плавающей точкой не подходят: 0.0 == -0.0, а NaN != NaN
+template<typename Type>
+inline constexpr bool kIsBitwiseComparable =
+    std::is_integral_v<Type> || std::is_enum_v<Type> || std::is_pointer_v<Type>;
+
+// Возвращает индекс первого различающегося байта a и b или size, если различий нет
+inline size_t MismatchBytes(const unsigned char *a, const unsigned char *b, size_t size) noexcept {
+  size_t i = 0;
+#if defined(__AVX2__)
+  // Блоки по 128 байт без различий пропускаются одной проверкой,
+  // различие внутри блока уточняется циклом по 32 байта ниже
+  for (; i + 128 <= size; i += 128) {
+    const auto *pa = reinterpret_cast<const __m256i *>(a + i);
+    const auto *pb = reinterpret_cast<const __m256i *>(b + i);
+    const __m256i equal = _mm256_and_si256(
+        _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256(pa), _mm256_loadu_si256(pb)),
+                         _mm256_cmpeq_epi8(_mm256_loadu_si256(pa + 1), _mm256_loadu_si256(pb + 1))),
+        _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256(pa + 2), _mm256_loadu_si256(pb + 2)),
+                         _mm256_cmpeq_epi8(_mm256_loadu_si256(pa + 3), _mm256_loadu_si256(pb + 3))));
+    if (_mm256_movemask_epi8(equal) != -1) {
+      break;
+    }
+  }
+  for (; i + 32 <= size; i += 32) {
+    const __m256i equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)),
+                                            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+    const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(equal));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+#endif
+#if defined(__SSE2__)
+  for (; i + 64 <= size; i += 64) {
+    const auto *pa = reinterpret_cast<const __m128i *>(a + i);
+    const auto *pb = reinterpret_cast<const __m128i *>(b + i);
+    const __m128i equal = _mm_and_si128(
+        _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(pa), _mm_loadu_si128(pb)),
+                      _mm_cmpeq_epi8(_mm_loadu_si128(pa + 1), _mm_loadu_si128(pb + 1))),
+        _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(pa + 2), _mm_loadu_si128(pb + 2)),
+                      _mm_cmpeq_epi8(_mm_loadu_si128(pa + 3), _mm_loadu_si128(pb + 3))));
+    if (_mm_movemask_epi8(equal) != 0xFFFF) {
+      break;
+    }
+  }
+  for (; i + 16 <= size; i += 16) {
+    const __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)),
+                                         _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i)));
+    const unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(equal)) & 0xFFFFu;
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 16 <= size; i += 16) {
+    const uint8x16_t equal = vceqq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+    // Сжимает 16 байтов маски до 16 полубайтов одного 64-битного слова
+    const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(equal), 4);
+    const uint64_t mask = ~vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+    if (mask != 0) {
+      return i + __builtin_ctzll(mask) / 4;
+    }
+  }
+#else
+  if (std::memcmp(a, b, size) == 0) {
+    return size;
+  }
+#endif
+  for (; i < size; ++i) {
+    if (a[i] != b[i]) {
+      return i;
+    }
+  }
+  return size;
+}
+
+// Возвращает индекс первого различающегося элемента a и b или size, если различий нет
+template<typename Type>
+size_t Mismatch(const Type *a, const Type *b, size_t size) {
+  if constexpr (kIsBitwiseComparable<Type>) {
+    if (size == 0) {
+      return 0;
+    }
+    return MismatchBytes(reinterpret_cast<const unsigned char *>(a), reinterpret_cast<const unsigned char *>(b),
+                         size * sizeof(Type)) / sizeof(Type);
+  } else {
+    return std::mismatch(a, a + size, b).first - a;
+  }
+}
+
+// Равны ли элементы диапазонов [a, a + size) и [b, b + size).
+// Для равенства место различия не нужно, и memcmp из стандартной библиотеки
+// (сам векторизованный под процессор) быстрее собственного ядра
+template<typename Type>
+SIMPLE_VECTOR_CONSTEXPR bool RangesEqual(const Type *a, const Type *b, size_t size) {
+  if constexpr (kIsBitwiseComparable<Type>) {
+    if (!IsConstantEvaluated()) {
+      return size == 0 || std::memcmp(a, b, size * sizeof(Type)) == 0;
+    }
+  }
+  return std::equal(a, a + size, b);
+}
+
+// Предшествует ли [a, a + a_size) диапазону [b, b + b_size) в лексикографическом порядке
+template<typename Type>
+SIMPLE_VECTOR_CONSTEXPR bool LexicographicalLess(const Type *a, size_t a_size, const Type *b, size_t b_size) {
+  if constexpr (kIsBitwiseComparable<Type>) {
+    if (!IsConstantEvaluated()) {
+      const size_t common = std::min(a_size, b_size);
+      if constexpr (std::is_same_v<std::remove_cv_t<Type>, unsigned char>) {
+        // Для байтов без знака порядок memcmp совпадает с лексикографическим
+        const int result = common == 0 ? 0 : std::memcmp(a, b, common);
+        return result != 0 ? result < 0 : a_size < b_size;
+      } else {
+        const size_t index = Mismatch(a, b, common);
+        return index != common ? a[index] < b[index] : a_size < b_size;
+      }
+    }
+  }
+  return std::lexicographical_compare(a, a + a_size, b, b + b_size);
+}
+
+}  // namespace detail
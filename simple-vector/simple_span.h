@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "checked_iterator.h"
+#include "simd_compare.h"
+
+// Невладеющее представление непрерывного диапазона элементов: указатель и размер.
+// Создаётся из SimpleVector (и любого вектора с begin() и GetSize()) или его части
+// и копируется без копирования элементов. Остаётся действительным, пока вектор
+// не перевыделит память или не будет разрушен.
+// SimpleSpan<const Type> даёт доступ только для чтения
+template<typename Type>
+class SimpleSpan {
+  template<typename Container>
+  using ContainerPointer = decltype(detail::ToAddress(std::declval<Container &>().begin()));
+
+  template<typename Container>
+  using RequireCompatibleContainer = std::enable_if_t<
+      std::is_pointer_v<ContainerPointer<Container>>
+          && std::is_convertible_v<std::remove_pointer_t<ContainerPointer<Container>> (*)[], Type (*)[]>
+          && !std::is_same_v<std::remove_cv_t<Container>, SimpleSpan>>;
+
+ public:
+  using Iterator = Type *;
+  using ConstIterator = const Type *;
+
+  // Обозначает «до конца диапазона» в Subspan
+  static constexpr size_t kToEnd = static_cast<size_t>(-1);
+
+  SimpleSpan() noexcept = default;
+
+  SimpleSpan(Type *data, size_t size) noexcept : data_(data), size_(size) {
+  }
+
+  SimpleSpan(Type *first, Type *last) noexcept : data_(first), size_(last - first) {
+    assert(first <= last);
+  }
+
+  // Представление всех элементов вектора
+  template<typename Container, typename = RequireCompatibleContainer<Container>>
+  SimpleSpan(Container &container) noexcept : data_(detail::ToAddress(container.begin())), size_(container.GetSize()) {
+  }
+
+  // SimpleSpan<Type> приводится к SimpleSpan<const Type>
+  template<typename Other, typename = std::enable_if_t<std::is_convertible_v<Other (*)[], Type (*)[]>>>
+  SimpleSpan(const SimpleSpan<Other> &other) noexcept : data_(other.Data()), size_(other.GetSize()) {
+  }
+
+  size_t GetSize() const noexcept {
+    return size_;
+  }
+
+  bool IsEmpty() const noexcept {
+    return size_ == 0;
+  }
+
+  Type *Data() const noexcept {
+    return data_;
+  }
+
+  Type &operator[](size_t index) const noexcept {
+    assert(index < size_);
+    return data_[index];
+  }
+
+  // Возвращает ссылку на элемент с индексом index.
+  // Выбрасывает исключение std::out_of_range, если index >= size
+  Type &At(size_t index) const {
+    if (index >= size_) {
+      throw std::out_of_range("Index is out of range");
+    }
+    return data_[index];
+  }
+
+  // Первые count элементов
+  SimpleSpan First(size_t count) const noexcept {
+    assert(count <= size_);
+    return SimpleSpan(data_, count);
+  }
+
+  // Последние count элементов
+  SimpleSpan Last(size_t count) const noexcept {
+    assert(count <= size_);
+    return SimpleSpan(data_ + (size_ - count), count);
+  }
+
+  // count элементов начиная с offset; kToEnd - все элементы до конца
+  SimpleSpan Subspan(size_t offset, size_t count = kToEnd) const noexcept {
+    assert(offset <= size_);
+    if (count == kToEnd) {
+      count = size_ - offset;
+    }
+    assert(count <= size_ - offset);
+    return SimpleSpan(data_ + offset, count);
+  }
+
+  Iterator begin() const noexcept {
+    return data_;
+  }
+
+  Iterator end() const noexcept {
+    return data_ + size_;
+  }
+
+  ConstIterator cbegin() const noexcept {
+    return data_;
+  }
+
+  ConstIterator cend() const noexcept {
+    return data_ + size_;
+  }
+
+ private:
+  Type *data_ = nullptr;
+  size_t size_ = 0;
+};
+
+template<typename Type>
+SimpleSpan(Type *, size_t) -> SimpleSpan<Type>;
+
+template<typename Type>
+SimpleSpan(Type *, Type *) -> SimpleSpan<Type>;
+
+template<typename Container>
+SimpleSpan(Container &)
+    -> SimpleSpan<std::remove_pointer_t<decltype(detail::ToAddress(std::declval<Container &>().begin()))>>;
+
+// Диапазоны сравниваются по элементам, как векторы
+template<typename Type, typename Other,
+    typename = std::enable_if_t<std::is_same_v<std::remove_cv_t<Type>, std::remove_cv_t<Other>>>>
+bool operator==(SimpleSpan<Type> lhs, SimpleSpan<Other> rhs) {
+  return lhs.GetSize() == rhs.GetSize()
+      && detail::RangesEqual<std::remove_cv_t<Type>>(lhs.Data(), rhs.Data(), lhs.GetSize());
+}
+
+template<typename Type, typename Other>
+bool operator!=(SimpleSpan<Type> lhs, SimpleSpan<Other> rhs) {
+  return !(lhs == rhs);
+}
+
+template<typename Type, typename Other,
+    typename = std::enable_if_t<std::is_same_v<std::remove_cv_t<Type>, std::remove_cv_t<Other>>>>
+bool operator<(SimpleSpan<Type> lhs, SimpleSpan<Other> rhs) {
+  return detail::LexicographicalLess<std::remove_cv_t<Type>>(lhs.Data(), lhs.GetSize(), rhs.Data(), rhs.GetSize());
+}
+
+template<typename Type, typename Other>
+bool operator<=(SimpleSpan<Type> lhs, SimpleSpan<Other> rhs) {
+  return !(rhs < lhs);
+}
+
+template<typename Type, typename Other>
+bool operator>(SimpleSpan<Type> lhs, SimpleSpan<Other> rhs) {
+  return rhs < lhs;
+}
+
+template<typename Type, typename Other>
+bool operator>=(SimpleSpan<Type> lhs, SimpleSpan<Other> rhs) {
+  return !(lhs < rhs);
+}
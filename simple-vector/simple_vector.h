@@ -3,16 +3,24 @@
 #include <cassert>
 #include <initializer_list>
 #include <algorithm>
+#include <memory>
 #include <stdexcept>
 
+#include "aligned_allocator.h"
 #include "array_ptr.h"
+#include "checked_iterator.h"
+#include "growth_policy.h"
+#include "instrumentation.h"
+#include "memory_utils.h"
+#include "parallel_algorithms.h"
+#include "simd_compare.h"
 
 class ReserveProxyObj {
  public:
-  explicit ReserveProxyObj(size_t size) : size_(size) {
+  constexpr explicit ReserveProxyObj(size_t size) : size_(size) {
   }
 
-  size_t GetReservedCapacity() const noexcept {
+  constexpr size_t GetReservedCapacity() const noexcept {
     return size_;
   }
 
@@ -20,96 +28,243 @@ class ReserveProxyObj {
   size_t size_ = 0;
 };
 
-ReserveProxyObj Reserve(size_t capacity_to_reserve) {
+constexpr ReserveProxyObj Reserve(size_t capacity_to_reserve) {
   return ReserveProxyObj(capacity_to_reserve);
 }
 
-template<typename Type>
+// Включает параллельное создание элементов в конструкторах SimpleVector
+// (см. parallel_algorithms.h). Аллокатор должен допускать вызовы construct
+// из нескольких потоков, как std::allocator и std::pmr::polymorphic_allocator
+class ParallelInitProxyObj {
+ public:
+  explicit ParallelInitProxyObj(const ParallelOptions &options) : options_(options) {
+  }
+
+  const ParallelOptions &GetOptions() const noexcept {
+    return options_;
+  }
+
+ private:
+  ParallelOptions options_;
+};
+
+inline ParallelInitProxyObj ParallelInit(const ParallelOptions &options = {}) {
+  return ParallelInitProxyObj(options);
+}
+
+// GrowthPolicy определяет, до какой вместимости растёт вектор, когда
+// в нём заканчивается место (см. growth_policy.h).
+// Instrumentation получает сообщения о выделениях памяти, переносах элементов,
+// перевыделениях и сдвигах (см. instrumentation.h)
+template<typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth,
+    typename Instrumentation = SIMPLE_VECTOR_DEFAULT_INSTRUMENTATION>
 class SimpleVector {
+  using AllocTraits = std::allocator_traits<Allocator>;
+
  public:
+#ifdef SIMPLE_VECTOR_CHECKED_ITERATORS
+  using Iterator = detail::CheckedIterator<Type, SimpleVector>;
+  using ConstIterator = detail::CheckedIterator<const Type, SimpleVector>;
+#else
   using Iterator = Type *;
   using ConstIterator = const Type *;
+#endif
+  using AllocatorType = Allocator;
+  using GrowthPolicyType = GrowthPolicy;
+  using InstrumentationType = Instrumentation;
+
+  constexpr SimpleVector() noexcept(noexcept(Allocator())) = default;
 
-  SimpleVector() noexcept = default;
+  SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(const Allocator &alloc) noexcept : array_(alloc) {
+  }
 
   // Создаёт вектор из size элементов, инициализированных значением по умолчанию
-  explicit SimpleVector(size_t size) : array_(size), size_(size), capacity_(size) {
-    std::generate(begin(), end(), []() { return Type{}; });
+  SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(size_t size, const Allocator &alloc = Allocator())
+      : array_(size, alloc), size_(size) {
+    RecordAllocation();
+    detail::UninitializedValueConstruct(array_.GetAllocator(), Data(), Data() + size_);
   }
 
-  explicit SimpleVector(ReserveProxyObj reserve_proxy_obj) {
+  SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(ReserveProxyObj reserve_proxy_obj, const Allocator &alloc = Allocator())
+      : array_(alloc) {
     Reserve(reserve_proxy_obj.GetReservedCapacity());
   }
 
   // Создаёт вектор из size элементов, инициализированных значением value
-  SimpleVector(size_t size, const Type &value)
-      : array_(size), size_(size), capacity_(size) {
-    std::fill(begin(), end(), value);
+  SIMPLE_VECTOR_CONSTEXPR SimpleVector(size_t size, const Type &value, const Allocator &alloc = Allocator())
+      : array_(size, alloc), size_(size) {
+    RecordAllocation();
+    detail::UninitializedFill(array_.GetAllocator(), Data(), Data() + size_, value);
   }
 
   // Создаёт вектор из std::initializer_list
-  SimpleVector(std::initializer_list<Type> init)
-      : array_(init.size()), size_(init.size()), capacity_(init.size()) {
-    std::copy(init.begin(), init.end(), array_.Get());
+  SIMPLE_VECTOR_CONSTEXPR SimpleVector(std::initializer_list<Type> init, const Allocator &alloc = Allocator())
+      : array_(init.size(), alloc), size_(init.size()) {
+    RecordAllocation();
+    detail::UninitializedCopy(array_.GetAllocator(), init.begin(), init.end(), Data());
   }
 
-  SimpleVector(const SimpleVector &other) {
-    SimpleVector copy(other.size_);
-    std::copy(other.begin(), other.end(), copy.begin());
-    swap(copy);
+  // Создаёт вектор из size элементов, инициализированных значением по умолчанию,
+  // создавая элементы параллельно
+  SimpleVector(ParallelInitProxyObj parallel, size_t size, const Allocator &alloc = Allocator())
+      : array_(size, alloc), size_(size) {
+    RecordAllocation();
+    auto &array_alloc = array_.GetAllocator();
+    detail::ParallelConstruct(array_alloc, Data(), Data() + size_, parallel.GetOptions(), [&](Type *first, Type *last) {
+      detail::UninitializedValueConstruct(array_alloc, first, last);
+    });
   }
 
-  SimpleVector(SimpleVector &&other) noexcept {
-    swap(other);
-    other.Clear();
+  // Создаёт вектор из size копий value, создавая элементы параллельно
+  SimpleVector(ParallelInitProxyObj parallel, size_t size, const Type &value, const Allocator &alloc = Allocator())
+      : array_(size, alloc), size_(size) {
+    RecordAllocation();
+    auto &array_alloc = array_.GetAllocator();
+    detail::ParallelConstruct(array_alloc, Data(), Data() + size_, parallel.GetOptions(), [&](Type *first, Type *last) {
+      detail::UninitializedFill(array_alloc, first, last, value);
+    });
   }
 
-  SimpleVector &operator=(const SimpleVector &rhs) {
+  // Создаёт копию other, копируя элементы параллельно
+  SimpleVector(ParallelInitProxyObj parallel, const SimpleVector &other)
+      : SimpleVector(parallel, other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+  }
+
+  SimpleVector(ParallelInitProxyObj parallel, const SimpleVector &other, const Allocator &alloc)
+      : array_(other.size_, alloc), size_(other.size_) {
+    RecordAllocation();
+    auto &array_alloc = array_.GetAllocator();
+    detail::ParallelConstruct(array_alloc, Data(), Data() + size_, parallel.GetOptions(), [&](Type *first, Type *last) {
+      const Type *source = other.Data() + (first - Data());
+      detail::UninitializedCopy(array_alloc, source, source + (last - first), first);
+    });
+    instrumentation_.OnCopy(size_);
+  }
+
+  SIMPLE_VECTOR_CONSTEXPR SimpleVector(const SimpleVector &other)
+      : SimpleVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+  }
+
+  // Создаёт копию other, память для которой выделяется аллокатором alloc
+  SIMPLE_VECTOR_CONSTEXPR SimpleVector(const SimpleVector &other, const Allocator &alloc)
+      : array_(other.size_, alloc), size_(other.size_) {
+    RecordAllocation();
+    detail::UninitializedCopy(array_.GetAllocator(), other.Data(), other.Data() + other.size_, Data());
+    instrumentation_.OnCopy(size_);
+  }
+
+  SIMPLE_VECTOR_CONSTEXPR SimpleVector(SimpleVector &&other) noexcept
+      : array_(std::move(other.array_)),
+        size_(std::exchange(other.size_, 0)),
+        instrumentation_(std::move(other.instrumentation_)) {
+    other.InvalidateIterators();
+  }
+
+  SIMPLE_VECTOR_CONSTEXPR ~SimpleVector() {
+    DestroyElements();
+  }
+
+  // Аллокатор заменяется аллокатором rhs, только если этого требует
+  // propagate_on_container_copy_assignment, и тогда заменяется всегда:
+  // равные аллокаторы могут различаться состоянием, которое не учитывает operator==.
+  // Если вместимости хватает, память не выделяется: существующим элементам присваиваются
+  // значения элементов rhs, недостающие создаются, лишние разрушаются.
+  // Если присваивание или создание элемента бросает исключение, часть элементов
+  // может уже получить новые значения
+  SIMPLE_VECTOR_CONSTEXPR SimpleVector &operator=(const SimpleVector &rhs) {
     if (this == &rhs) {
       return *this;
     }
-    SimpleVector copy(rhs);
-    swap(copy);
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+      if (GetAllocator() != rhs.GetAllocator()) {
+        // Память, выделенную старым аллокатором, нужно освободить им же
+        Clear();
+        array_.ReplaceAllocator(rhs.GetAllocator());
+        InvalidateIterators();
+      } else {
+        array_.AssignEqualAllocator(rhs.GetAllocator());
+      }
+    }
+    Assign(rhs.Data(), rhs.Data() + rhs.size_);
+    instrumentation_.OnCopy(size_);
     return *this;
   }
 
-  SimpleVector &operator=(SimpleVector &&rhs) noexcept {
+  // Если аллокатор не передаётся (propagate_on_container_move_assignment == false)
+  // и аллокаторы не равны, забрать память rhs нельзя, и элементы перемещаются по одному
+  SIMPLE_VECTOR_CONSTEXPR SimpleVector &operator=(SimpleVector &&rhs) noexcept(
+      AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
     if (this == &rhs) {
       return *this;
     }
-    SimpleVector copy(std::move(rhs));
-    swap(copy);
+    if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+        && !AllocTraits::is_always_equal::value) {
+      if (GetAllocator() != rhs.GetAllocator()) {
+        Clear();
+        Reserve(rhs.size_);
+        detail::UninitializedMove(array_.GetAllocator(), rhs.Data(), rhs.Data() + rhs.size_, Data());
+        instrumentation_.OnMove(rhs.size_);
+        size_ = rhs.size_;
+        rhs.Clear();
+        InvalidateIterators();
+        rhs.InvalidateIterators();
+        return *this;
+      }
+    }
+    DestroyElements();
+    array_ = std::move(rhs.array_);
+    size_ = std::exchange(rhs.size_, 0);
+    InvalidateIterators();
+    rhs.InvalidateIterators();
     return *this;
   }
 
+  // Возвращает копию аллокатора вектора
+  SIMPLE_VECTOR_CONSTEXPR Allocator GetAllocator() const noexcept {
+    return array_.GetAllocator();
+  }
+
+  // Возвращает объект политики инструментирования этого вектора
+  SIMPLE_VECTOR_CONSTEXPR const Instrumentation &GetInstrumentation() const noexcept {
+    return instrumentation_;
+  }
+
   // Возвращает количество элементов в массиве
-  size_t GetSize() const noexcept {
+  SIMPLE_VECTOR_CONSTEXPR size_t GetSize() const noexcept {
     return size_;
   }
 
   // Возвращает вместимость массива
-  size_t GetCapacity() const noexcept {
-    return capacity_;
+  SIMPLE_VECTOR_CONSTEXPR size_t GetCapacity() const noexcept {
+    return array_.GetSize();
+  }
+
+  // Возвращает вместимость, которая будет у вектора после увеличения размера до new_size.
+  // Позволяет заранее узнать, приведёт ли добавление элементов к перевыделению памяти
+  SIMPLE_VECTOR_CONSTEXPR size_t GetGrowthCapacity(size_t new_size) const noexcept {
+    return new_size <= GetCapacity() ? GetCapacity() : CalculateCapacity(new_size);
   }
 
   // Сообщает, пустой ли массив
-  bool IsEmpty() const noexcept {
+  SIMPLE_VECTOR_CONSTEXPR bool IsEmpty() const noexcept {
     return size_ == 0;
   }
 
   // Возвращает ссылку на элемент с индексом index
-  Type &operator[](size_t index) noexcept {
+  SIMPLE_VECTOR_CONSTEXPR Type &operator[](size_t index) SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(index < size_, "index is out of range");
     return array_[index];
   }
 
   // Возвращает константную ссылку на элемент с индексом index
-  const Type &operator[](size_t index) const noexcept {
+  SIMPLE_VECTOR_CONSTEXPR const Type &operator[](size_t index) const SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(index < size_, "index is out of range");
     return array_[index];
   }
 
   // Возвращает константную ссылку на элемент с индексом index
   // Выбрасывает исключение std::out_of_range, если index >= size
-  Type &At(size_t index) {
+  SIMPLE_VECTOR_CONSTEXPR Type &At(size_t index) {
     if (index >= size_) {
       throw std::out_of_range("out_of_range");
     }
@@ -118,169 +273,617 @@ class SimpleVector {
 
   // Возвращает константную ссылку на элемент с индексом index
   // Выбрасывает исключение std::out_of_range, если index >= size
-  const Type &At(size_t index) const {
+  SIMPLE_VECTOR_CONSTEXPR const Type &At(size_t index) const {
     if (index >= size_) {
       throw std::out_of_range("out_of_range");
     }
     return array_[index];
   }
 
-  // Обнуляет размер массива, не изменяя его вместимость
-  void Clear() noexcept {
+  // Разрушает все элементы и обнуляет размер массива, не изменяя его вместимость
+  SIMPLE_VECTOR_CONSTEXPR void Clear() noexcept {
+    DestroyElements();
     size_ = 0;
   }
 
   // Изменяет размер массива.
+  // При уменьшении размера лишние элементы разрушаются.
   // При увеличении размера новые элементы получают значение по умолчанию для типа Type
-  void Resize(size_t new_size) {
-    if (new_size < size_) {
-      size_ = new_size;
-      return;
-    }
-    if (new_size > size_ && new_size <= capacity_) {
-      std::generate(begin() + size_, begin() + new_size, []() { return Type{}; });
-      size_ = new_size;
-      return;
-    }
-    if (new_size > capacity_) {
-      auto new_capacity = std::max(new_size, size_ * 2);
-      Reserve(new_capacity);
-      std::generate(array_.Get() + size_, array_.Get() + new_size, []() { return Type{}; });
-      size_ = new_size;
-    }
+  SIMPLE_VECTOR_CONSTEXPR void Resize(size_t new_size) {
+    ResizeWith(new_size, [](Allocator &alloc, Type *first, Type *last) {
+      detail::UninitializedValueConstruct(alloc, first, last);
+    });
+  }
+
+  // Изменяет размер массива. Новые элементы создаются копиями value.
+  // value может быть элементом самого вектора
+  SIMPLE_VECTOR_CONSTEXPR void Resize(size_t new_size, const Type &value) {
+    ResizeWith(new_size, [&value](Allocator &alloc, Type *first, Type *last) {
+      detail::UninitializedFill(alloc, first, last, value);
+    });
+  }
+
+  // Изменяет размер массива. Новые элементы инициализируются по умолчанию (как `new Type`),
+  // поэтому элементы тривиальных типов не обнуляются и содержат неопределённые значения
+  SIMPLE_VECTOR_CONSTEXPR void ResizeDefaultInit(size_t new_size) {
+    ResizeWith(new_size, [](Allocator &alloc, Type *first, Type *last) {
+      detail::UninitializedDefaultConstruct(alloc, first, last);
+    });
+  }
+
+  // Изменяет размер массива, не записывая ничего в память новых элементов.
+  // Нужен, чтобы заполнить вектор напрямую, например, через read() в Data().
+  // Читать новые элементы до того, как им присвоены значения, нельзя
+  SIMPLE_VECTOR_CONSTEXPR void ResizeUninitialized(size_t new_size) {
+    static_assert(std::is_trivially_default_constructible_v<Type>,
+                  "ResizeUninitialized requires a trivially default constructible type");
+    ResizeDefaultInit(new_size);
   }
 
   // Добавляет элемент в конец вектора
   // При нехватке места увеличивает вдвое вместимость вектора
-  void PushBack(const Type &item) {
-    Resize(size_ + 1);
-    array_[size_ - 1] = item;
+  SIMPLE_VECTOR_CONSTEXPR void PushBack(const Type &item) {
+    EmplaceBack(item);
+  }
+
+  SIMPLE_VECTOR_CONSTEXPR void PushBack(Type &&item) {
+    EmplaceBack(std::move(item));
   }
 
-  void PushBack(Type &&item) {
-    Resize(size_ + 1);
-    array_[size_ - 1] = std::move(item);
+  // Создаёт элемент из аргументов args прямо в конце вектора.
+  // Возвращает ссылку на созданный элемент
+  template<typename... Args>
+  SIMPLE_VECTOR_CONSTEXPR Type &EmplaceBack(Args &&... args) {
+    if (size_ == GetCapacity()) {
+      ReallocateAndEmplace(size_, std::forward<Args>(args)...);
+    } else {
+      AllocTraits::construct(array_.GetAllocator(), Data() + size_, std::forward<Args>(args)...);
+      ++size_;
+    }
+    return array_[size_ - 1];
   }
 
   // Вставляет значение value в позицию pos.
   // Возвращает итератор на вставленное значение
   // Если перед вставкой значения вектор был заполнен полностью,
   // вместимость вектора должна увеличиться вдвое, а для вектора вместимостью 0 стать равной 1
-  Iterator Insert(ConstIterator pos, const Type &value) {
-    auto index = std::distance(cbegin(), pos);
-    Resize(size_ + 1);
-    std::copy_backward(cbegin() + index, cend() - 1, end());
-    array_[index] = value;
-    return Iterator(&array_[index]);
-  }
-
-  Iterator Insert(ConstIterator pos, Type &&value) {
-    auto index = std::distance(cbegin(), pos);
-    Resize(size_ + 1);
-    std::move_backward(begin() + index, end() - 1, end());
-    array_[index] = std::move(value);
-    return Iterator(&array_[index]);
+  SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, const Type &value) {
+    return Emplace(pos, value);
+  }
+
+  SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, Type &&value) {
+    return Emplace(pos, std::move(value));
+  }
+
+  // Создаёт элемент из аргументов args в позиции pos.
+  // Возвращает итератор на созданный элемент.
+  // При вставке в конец и при перевыделении памяти элемент создаётся сразу на своём месте.
+  // При вставке в середину без перевыделения args могут ссылаться на сдвигаемые элементы,
+  // поэтому элемент создаётся во временном объекте и перемещается на место
+  template<typename... Args>
+  SIMPLE_VECTOR_CONSTEXPR Iterator Emplace(ConstIterator pos, Args &&... args) {
+    const size_t index = IndexOf(pos);
+    if (size_ == GetCapacity()) {
+      ReallocateAndEmplace(index, std::forward<Args>(args)...);
+    } else if (index == size_) {
+      AllocTraits::construct(array_.GetAllocator(), Data() + size_, std::forward<Args>(args)...);
+      ++size_;
+    } else {
+      Type temp(std::forward<Args>(args)...);
+      AllocTraits::construct(array_.GetAllocator(), Data() + size_, std::move(Data()[size_ - 1]));
+      ++size_;
+      detail::MoveBackward(Data() + index, Data() + size_ - 2, Data() + size_ - 1);
+      RecordShift(size_ - index - 1);
+      array_[index] = std::move(temp);
+    }
+    return begin() + index;
+  }
+
+  // Вставляет в позицию pos копии элементов [first, last), которые не должны
+  // принадлежать самому вектору. Возвращает итератор на первый вставленный элемент.
+  // Для однонаправленных итераторов размер вычисляется заранее: память выделяется
+  // не больше одного раза, а хвост вектора сдвигается один раз.
+  // Элементы из итераторов ввода добавляются в конец и затем переставляются на место
+  template<typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+  SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, InputIt first, InputIt last) {
+    const size_t index = IndexOf(pos);
+    if constexpr (detail::kIsForwardIterator<InputIt>) {
+      const size_t count = std::distance(first, last);
+      if (size_ + count > GetCapacity()) {
+        ReallocateAndInsert(index, count, [&](Allocator &alloc, Type *dest) {
+          return detail::UninitializedCopy(alloc, first, last, dest);
+        });
+      } else if (count != 0) {
+        InsertRangeInPlace(index, count, first, last);
+      }
+    } else {
+      const size_t old_size = size_;
+      for (; first != last; ++first) {
+        EmplaceBack(*first);
+      }
+      std::rotate(Data() + index, Data() + old_size, Data() + size_);
+    }
+    return begin() + index;
+  }
+
+  // Вставляет в позицию pos count копий value.
+  // Возвращает итератор на первый вставленный элемент
+  SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, size_t count, const Type &value) {
+    const size_t index = IndexOf(pos);
+    if (size_ + count > GetCapacity()) {
+      ReallocateAndInsert(index, count, [&](Allocator &alloc, Type *dest) {
+        detail::UninitializedFill(alloc, dest, dest + count, value);
+        return dest + count;
+      });
+    } else if (count != 0) {
+      InsertFillInPlace(index, count, value);
+    }
+    return begin() + index;
+  }
+
+  // Добавляет в конец вектора копии элементов [first, last)
+  template<typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+  SIMPLE_VECTOR_CONSTEXPR void Append(InputIt first, InputIt last) {
+    Insert(cend(), first, last);
+  }
+
+  // Заменяет содержимое вектора копиями элементов [first, last).
+  // Существующим элементам значения присваиваются, недостающие создаются, лишние разрушаются.
+  // Новая память выделяется, только если диапазон не помещается в текущую вместимость
+  template<typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+  SIMPLE_VECTOR_CONSTEXPR void Assign(InputIt first, InputIt last) {
+    if constexpr (detail::kIsForwardIterator<InputIt>) {
+      const size_t count = std::distance(first, last);
+      if (count > GetCapacity()) {
+        // Старые элементы не переносятся, а заменяются копиями диапазона
+        const size_t old_capacity = GetCapacity();
+        detail::NotifyReallocateBegin(instrumentation_, old_capacity, count);
+        auto new_array = AllocateStorage(count);
+        detail::UninitializedCopy(new_array.GetAllocator(), first, last, new_array.Get());
+        DestroyElements();
+        array_.swap(new_array);
+        InvalidateIterators();
+        detail::NotifyReallocateEnd(instrumentation_, old_capacity, count, 0);
+      } else if (count <= size_) {
+        Type *new_end = std::copy(first, last, Data());
+        detail::Destroy(array_.GetAllocator(), new_end, Data() + size_);
+      } else {
+        auto mid = std::next(first, size_);
+        std::copy(first, mid, Data());
+        detail::UninitializedCopy(array_.GetAllocator(), mid, last, Data() + size_);
+      }
+      size_ = count;
+    } else {
+      Clear();
+      for (; first != last; ++first) {
+        EmplaceBack(*first);
+      }
+    }
   }
 
-  // "Удаляет" последний элемент вектора. Вектор не должен быть пустым
-  void PopBack() noexcept {
+  // Удаляет последний элемент вектора. Вектор не должен быть пустым
+  SIMPLE_VECTOR_CONSTEXPR void PopBack() SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(!IsEmpty(), "PopBack of empty vector");
     assert(!IsEmpty());
-    size_ -= 1;
+    --size_;
+    AllocTraits::destroy(array_.GetAllocator(), Data() + size_);
   }
 
   // Удаляет элемент вектора в указанной позиции
-  Iterator Erase(ConstIterator pos) {
-    assert(pos >= begin() && pos < end());
-    auto index = std::distance(cbegin(), pos);
-    std::move(begin() + index + 1, end(), &array_[index]);
-    --size_;
-    return Iterator(&array_[index]);
+  SIMPLE_VECTOR_CONSTEXPR Iterator Erase(ConstIterator pos) {
+    const size_t index = IndexOf(pos);
+    detail::Check(index < size_, "Erase of end()");
+    assert(index < size_);
+    detail::MoveForward(Data() + index + 1, Data() + size_, Data() + index);
+    RecordShift(size_ - index - 1);
+    PopBack();
+    return begin() + index;
+  }
+
+  // Удаляет элементы [first, last). Хвост вектора сдвигается один раз.
+  // Возвращает итератор на элемент, следовавший за удалёнными
+  SIMPLE_VECTOR_CONSTEXPR Iterator Erase(ConstIterator first, ConstIterator last) {
+    const size_t first_index = IndexOf(first);
+    const size_t last_index = IndexOf(last);
+    detail::Check(first_index <= last_index, "Erase of reversed range");
+    assert(first_index <= last_index);
+    if (first_index != last_index) {
+      detail::MoveForward(Data() + last_index, Data() + size_, Data() + first_index);
+      RecordShift(size_ - last_index);
+      const size_t new_size = size_ - (last_index - first_index);
+      detail::Destroy(array_.GetAllocator(), Data() + new_size, Data() + size_);
+      size_ = new_size;
+    }
+    return begin() + first_index;
+  }
+
+  // Удаляет все элементы, для которых pred возвращает true, за один проход:
+  // оставшиеся элементы перемещаются на свои места по одному разу, порядок сохраняется.
+  // Возвращает число удалённых элементов
+  template<typename Predicate>
+  SIMPLE_VECTOR_CONSTEXPR size_t EraseIf(Predicate pred) {
+    Type *const data = Data();
+    size_t kept = 0;
+    while (kept != size_ && !pred(std::as_const(data[kept]))) {
+      ++kept;
+    }
+    size_t moved = 0;
+    for (size_t index = kept + 1; index < size_; ++index) {
+      if (!pred(std::as_const(data[index]))) {
+        data[kept++] = std::move(data[index]);
+        ++moved;
+      }
+    }
+    RecordShift(moved);
+    const size_t removed = size_ - kept;
+    detail::Destroy(array_.GetAllocator(), data + kept, data + size_);
+    size_ = kept;
+    return removed;
+  }
+
+  // Удаляет элемент в позиции pos за O(1), перемещая на его место последний элемент.
+  // Порядок остальных элементов не сохраняется.
+  // Возвращает итератор на элемент, занявший место удалённого
+  SIMPLE_VECTOR_CONSTEXPR Iterator UnorderedErase(ConstIterator pos) {
+    const size_t index = IndexOf(pos);
+    detail::Check(index < size_, "Erase of end()");
+    assert(index < size_);
+    if (index != size_ - 1) {
+      array_[index] = std::move(array_[size_ - 1]);
+      instrumentation_.OnMove(1);
+    }
+    PopBack();
+    return begin() + index;
+  }
+
+  // Увеличивает вместимость вектора до new_capacity.
+  // Выделяет память одним блоком и переносит в неё только существующие элементы.
+  // Если перенос элементов бросает исключение, вектор остаётся прежним
+  SIMPLE_VECTOR_CONSTEXPR void Reserve(size_t new_capacity) {
+    if (new_capacity > GetCapacity()) {
+      Reallocate(new_capacity);
+    }
   }
 
-  void Reserve(size_t new_capacity) {
-    if (new_capacity > capacity_) {
-      ArrayPtr<Type> new_array(new_capacity);
-      std::move(begin(), end(), new_array.Get());
-      array_.swap(new_array);
-      capacity_ = new_capacity;
+  // Уменьшает вместимость вектора до его размера.
+  // Элементы переносятся в блок памяти ровно под size элементов;
+  // пустой вектор освобождает память полностью
+  SIMPLE_VECTOR_CONSTEXPR void ShrinkToFit() {
+    if (size_ == GetCapacity()) {
+      return;
+    }
+    if (size_ == 0) {
+      array_.Reset();
+      InvalidateIterators();
+      return;
     }
+    Reallocate(size_);
   }
 
-  // Обменивает значение с другим вектором
-  void swap(SimpleVector &other) noexcept {
+  // Разрушает все элементы и освобождает память. Размер и вместимость становятся равны 0
+  SIMPLE_VECTOR_CONSTEXPR void Reset() noexcept {
+    Clear();
+    array_.Reset();
+    InvalidateIterators();
+  }
+
+  // Обменивает значение с другим вектором.
+  // Аллокаторы обмениваются, только если этого требует propagate_on_container_swap,
+  // иначе они должны быть равны
+  SIMPLE_VECTOR_CONSTEXPR void swap(SimpleVector &other) noexcept {
+    assert(AllocTraits::propagate_on_container_swap::value || GetAllocator() == other.GetAllocator());
     array_.swap(other.array_);
     std::swap(size_, other.size_);
-    std::swap(capacity_, other.capacity_);
+    std::swap(instrumentation_, other.instrumentation_);
+    InvalidateIterators();
+    other.InvalidateIterators();
+  }
+
+  // Возвращает указатель на первый элемент
+  // Для пустого массива может быть равен (или не равен) nullptr
+  SIMPLE_VECTOR_CONSTEXPR Type *Data() noexcept {
+    return array_.Get();
+  }
+
+  SIMPLE_VECTOR_CONSTEXPR const Type *Data() const noexcept {
+    return array_.Get();
   }
 
   // Возвращает итератор на начало массива
   // Для пустого массива может быть равен (или не равен) nullptr
-  Iterator begin() noexcept {
-    return Iterator(&array_[0]);
+  SIMPLE_VECTOR_CONSTEXPR Iterator begin() noexcept {
+    return MakeIterator(array_.Get());
   }
 
   // Возвращает итератор на элемент, следующий за последним
   // Для пустого массива может быть равен (или не равен) nullptr
-  Iterator end() noexcept {
-    return Iterator(&array_[size_]);
+  SIMPLE_VECTOR_CONSTEXPR Iterator end() noexcept {
+    return MakeIterator(array_.Get() + size_);
   }
 
   // Возвращает константный итератор на начало массива
   // Для пустого массива может быть равен (или не равен) nullptr
-  ConstIterator begin() const noexcept {
-    return ConstIterator(&array_[0]);
+  SIMPLE_VECTOR_CONSTEXPR ConstIterator begin() const noexcept {
+    return MakeIterator(static_cast<const Type *>(array_.Get()));
   }
 
   // Возвращает итератор на элемент, следующий за последним
   // Для пустого массива может быть равен (или не равен) nullptr
-  ConstIterator end() const noexcept {
-    return ConstIterator(&array_[size_]);
+  SIMPLE_VECTOR_CONSTEXPR ConstIterator end() const noexcept {
+    return MakeIterator(static_cast<const Type *>(array_.Get() + size_));
   }
 
   // Возвращает константный итератор на начало массива
   // Для пустого массива может быть равен (или не равен) nullptr
-  ConstIterator cbegin() const noexcept {
-    return ConstIterator(&array_[0]);
+  SIMPLE_VECTOR_CONSTEXPR ConstIterator cbegin() const noexcept {
+    return MakeIterator(static_cast<const Type *>(array_.Get()));
   }
 
   // Возвращает итератор на элемент, следующий за последним
   // Для пустого массива может быть равен (или не равен) nullptr
-  ConstIterator cend() const noexcept {
-    return ConstIterator(&array_[size_]);
+  SIMPLE_VECTOR_CONSTEXPR ConstIterator cend() const noexcept {
+    return MakeIterator(static_cast<const Type *>(array_.Get() + size_));
+  }
+
+  // Возвращает указатель на первый элемент, сообщая компилятору выравнивание данных,
+  // которое гарантирует аллокатор (например, AlignedAllocator), чтобы циклы по нему
+  // векторизовались с выровненными загрузками
+  Type *AlignedData() noexcept {
+    return AssumeAligned<detail::kAllocatorAlignment<Allocator>>(array_.Get());
+  }
+
+  const Type *AlignedData() const noexcept {
+    return AssumeAligned<detail::kAllocatorAlignment<Allocator>>(static_cast<const Type *>(array_.Get()));
   }
 
  private:
-  ArrayPtr<Type> array_;
+#ifdef SIMPLE_VECTOR_CHECKED_ITERATORS
+  template<typename, typename>
+  friend class detail::CheckedIterator;
+#endif
+
+  SIMPLE_VECTOR_CONSTEXPR Iterator MakeIterator(Type *ptr) noexcept {
+#ifdef SIMPLE_VECTOR_CHECKED_ITERATORS
+    return Iterator(this, ptr);
+#else
+    return ptr;
+#endif
+  }
+
+  SIMPLE_VECTOR_CONSTEXPR ConstIterator MakeIterator(const Type *ptr) const noexcept {
+#ifdef SIMPLE_VECTOR_CHECKED_ITERATORS
+    return ConstIterator(this, ptr);
+#else
+    return ptr;
+#endif
+  }
+
+  // Индекс позиции pos для вставки и удаления. В режиме проверки итераторов
+  // pos должен быть действительным итератором этого вектора
+  SIMPLE_VECTOR_CONSTEXPR size_t IndexOf(ConstIterator pos) const SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+#ifdef SIMPLE_VECTOR_CHECKED_ITERATORS
+    pos.CheckOwner(this);
+#endif
+    assert(pos >= cbegin() && pos <= cend());
+    return std::distance(cbegin(), pos);
+  }
+
+  // Делает недействительными итераторы, полученные до перевыделения памяти
+  SIMPLE_VECTOR_CONSTEXPR void InvalidateIterators() noexcept {
+#ifdef SIMPLE_VECTOR_CHECKED_ITERATORS
+    ++generation_;
+#endif
+  }
+
+  // Вместимость, до которой нужно вырасти, чтобы вместить new_size элементов
+  SIMPLE_VECTOR_CONSTEXPR size_t CalculateCapacity(size_t new_size) const noexcept {
+    return GrowthPolicy::NextCapacity(GetCapacity(), new_size, sizeof(Type));
+  }
+
+  // Изменяет размер массива, создавая новые элементы вызовом construct(alloc, first, last).
+  // При перевыделении новые элементы создаются до переноса существующих,
+  // так как construct может ссылаться на элементы вектора
+  template<typename ConstructFn>
+  SIMPLE_VECTOR_CONSTEXPR void ResizeWith(size_t new_size, ConstructFn construct) {
+    if (new_size <= size_) {
+      detail::Destroy(array_.GetAllocator(), Data() + new_size, Data() + size_);
+      size_ = new_size;
+      return;
+    }
+    const size_t count = new_size - size_;
+    if (new_size > GetCapacity()) {
+      ReallocateAndInsert(size_, count, [&](Allocator &alloc, Type *dest) {
+        construct(alloc, dest, dest + count);
+        return dest + count;
+      });
+      return;
+    }
+    construct(array_.GetAllocator(), Data() + size_, Data() + new_size);
+    size_ = new_size;
+  }
+
+  // Выделяет новую память, создаёт в ней элемент из args в позиции index
+  // и переносит вокруг него существующие элементы.
+  // Новый элемент создаётся до переноса, так как args могут ссылаться на элементы вектора.
+  // Если создание или перенос бросает исключение, вектор остаётся прежним
+  template<typename... Args>
+  SIMPLE_VECTOR_CONSTEXPR void ReallocateAndEmplace(size_t index, Args &&... args) {
+    ReallocateAndInsert(index, 1, [&](Allocator &alloc, Type *dest) {
+      AllocTraits::construct(alloc, dest, std::forward<Args>(args)...);
+      return dest + 1;
+    });
+  }
+
+  // Выделяет новую память под size_ + count элементов, создаёт в ней count новых
+  // элементов в позиции index вызовом construct(alloc, dest) и переносит вокруг них
+  // существующие элементы. construct возвращает адрес за последним созданным элементом.
+  // Если создание или перенос бросает исключение, вектор остаётся прежним
+  template<typename ConstructFn>
+  SIMPLE_VECTOR_CONSTEXPR void ReallocateAndInsert(size_t index, size_t count, ConstructFn construct) {
+    const size_t old_capacity = GetCapacity();
+    const size_t new_capacity = CalculateCapacity(size_ + count);
+    detail::NotifyReallocateBegin(instrumentation_, old_capacity, new_capacity);
+    auto new_array = AllocateStorage(new_capacity);
+    auto &alloc = new_array.GetAllocator();
+    Type *const new_data = new_array.Get();
+
+    detail::ConstructionGuard inserted(alloc, new_data + index, construct(alloc, new_data + index));
+    detail::ConstructionGuard prefix(alloc, new_data,
+                                     Relocate(alloc, Data(), Data() + index, new_data));
+    Relocate(alloc, Data() + index, Data() + size_, new_data + index + count);
+    prefix.Release();
+    inserted.Release();
+
+    DestroyElements();
+    array_.swap(new_array);
+    detail::NotifyReallocateEnd(instrumentation_, old_capacity, new_capacity, size_ * sizeof(Type));
+    size_ += count;
+    InvalidateIterators();
+  }
+
+  // Переносит элементы в новый блок памяти под new_capacity элементов
+  SIMPLE_VECTOR_CONSTEXPR void Reallocate(size_t new_capacity) {
+    const size_t old_capacity = GetCapacity();
+    detail::NotifyReallocateBegin(instrumentation_, old_capacity, new_capacity);
+    auto new_array = AllocateStorage(new_capacity);
+    Relocate(new_array.GetAllocator(), Data(), Data() + size_, new_array.Get());
+    DestroyElements();
+    array_.swap(new_array);
+    InvalidateIterators();
+    detail::NotifyReallocateEnd(instrumentation_, old_capacity, new_capacity, size_ * sizeof(Type));
+  }
+
+  // Вставляет count элементов [first, last) в позицию index, когда хватает вместимости.
+  // Хвост вектора сдвигается за один проход: часть, попадающая за старый конец,
+  // переносится в неинициализированную память, остальное сдвигается присваиванием
+  template<typename ForwardIt>
+  SIMPLE_VECTOR_CONSTEXPR void InsertRangeInPlace(size_t index, size_t count, ForwardIt first, ForwardIt last) {
+    auto &alloc = array_.GetAllocator();
+    Type *const pos = Data() + index;
+    Type *const old_end = Data() + size_;
+    const size_t tail = size_ - index;
+    if (tail > count) {
+      detail::UninitializedMove(alloc, old_end - count, old_end, old_end);
+      size_ += count;
+      detail::MoveBackward(pos, old_end - count, old_end);
+      RecordShift(tail);
+      std::copy(first, last, pos);
+    } else {
+      auto mid = std::next(first, tail);
+      detail::ConstructionGuard guard(alloc, old_end, detail::UninitializedCopy(alloc, mid, last, old_end));
+      detail::UninitializedMove(alloc, pos, old_end, pos + count);
+      RecordShift(tail);
+      guard.Release();
+      size_ += count;
+      std::copy(first, mid, pos);
+    }
+  }
+
+  // Вставляет count копий value в позицию index, когда хватает вместимости
+  SIMPLE_VECTOR_CONSTEXPR void InsertFillInPlace(size_t index, size_t count, const Type &value) {
+    // value может ссылаться на сдвигаемый элемент вектора
+    const Type copy(value);
+    auto &alloc = array_.GetAllocator();
+    Type *const pos = Data() + index;
+    Type *const old_end = Data() + size_;
+    const size_t tail = size_ - index;
+    if (tail > count) {
+      detail::UninitializedMove(alloc, old_end - count, old_end, old_end);
+      size_ += count;
+      detail::MoveBackward(pos, old_end - count, old_end);
+      RecordShift(tail);
+      std::fill_n(pos, count, copy);
+    } else {
+      detail::UninitializedFill(alloc, old_end, pos + count, copy);
+      detail::ConstructionGuard guard(alloc, old_end, pos + count);
+      detail::UninitializedMove(alloc, pos, old_end, pos + count);
+      RecordShift(tail);
+      guard.Release();
+      size_ += count;
+      std::fill(pos, old_end, copy);
+    }
+  }
+
+  // Выделяет память под capacity элементов тем же аллокатором, что и у вектора
+  SIMPLE_VECTOR_CONSTEXPR ArrayPtr<Type, Allocator> AllocateStorage(size_t capacity) {
+    ArrayPtr<Type, Allocator> storage(capacity, array_.GetAllocator());
+    instrumentation_.OnAllocate(capacity, capacity * sizeof(Type));
+    return storage;
+  }
+
+  // Сообщает политике инструментирования о сдвиге count элементов внутри буфера
+  SIMPLE_VECTOR_CONSTEXPR void RecordShift(size_t count) noexcept {
+    instrumentation_.OnMove(count);
+    detail::NotifyShift(instrumentation_, count * sizeof(Type));
+  }
+
+  // Сообщает политике инструментирования о памяти, выделенной в конструкторе
+  SIMPLE_VECTOR_CONSTEXPR void RecordAllocation() noexcept {
+    if (GetCapacity() != 0) {
+      instrumentation_.OnAllocate(GetCapacity(), GetCapacity() * sizeof(Type));
+    }
+  }
+
+  // Переносит элементы при перевыделении памяти (см. detail::UninitializedRelocate)
+  SIMPLE_VECTOR_CONSTEXPR Type *Relocate(Allocator &alloc, Type *first, Type *last, Type *dest) {
+    Type *result = detail::UninitializedRelocate(alloc, first, last, dest);
+    if constexpr (detail::kRelocatesByCopy<Type>) {
+      instrumentation_.OnCopy(last - first);
+    } else {
+      instrumentation_.OnMove(last - first);
+    }
+    return result;
+  }
+
+  SIMPLE_VECTOR_CONSTEXPR void DestroyElements() noexcept {
+    detail::Destroy(array_.GetAllocator(), Data(), Data() + size_);
+  }
+
+  ArrayPtr<Type, Allocator> array_;
   size_t size_ = 0;
-  size_t capacity_ = 0;
+  [[no_unique_address]] Instrumentation instrumentation_;
+#ifdef SIMPLE_VECTOR_CHECKED_ITERATORS
+  // Номер поколения памяти, который запоминают итераторы
+  size_t generation_ = 0;
+#endif
 };
 
-template<typename Type>
-inline bool operator==(const SimpleVector<Type> &lhs, const SimpleVector<Type> &rhs) {
-  return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+// Вектор, данные которого выровнены по Alignment байт (по умолчанию - по кэш-линии)
+template<typename Type, size_t Alignment = 64, typename GrowthPolicy = DoublingGrowth>
+using AlignedSimpleVector = SimpleVector<Type, AlignedAllocator<Type, Alignment>, GrowthPolicy>;
+
+template<typename Type, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+inline SIMPLE_VECTOR_CONSTEXPR bool operator==(const SimpleVector<Type, Allocator, GrowthPolicy, Instrumentation> &lhs,
+                                               const SimpleVector<Type, Allocator, GrowthPolicy, Instrumentation> &rhs) {
+  return lhs.GetSize() == rhs.GetSize() && detail::RangesEqual(lhs.Data(), rhs.Data(), lhs.GetSize());
 }
 
-template<typename Type>
-inline bool operator!=(const SimpleVector<Type> &lhs, const SimpleVector<Type> &rhs) {
+template<typename Type, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+inline SIMPLE_VECTOR_CONSTEXPR bool operator!=(const SimpleVector<Type, Allocator, GrowthPolicy, Instrumentation> &lhs,
+                                               const SimpleVector<Type, Allocator, GrowthPolicy, Instrumentation> &rhs) {
   return !(lhs == rhs);
 }
 
-template<typename Type>
-inline bool operator<(const SimpleVector<Type> &lhs, const SimpleVector<Type> &rhs) {
-  return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+template<typename Type, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+inline SIMPLE_VECTOR_CONSTEXPR bool operator<(const SimpleVector<Type, Allocator, GrowthPolicy, Instrumentation> &lhs,
+                                              const SimpleVector<Type, Allocator, GrowthPolicy, Instrumentation> &rhs) {
+  return detail::LexicographicalLess(lhs.Data(), lhs.GetSize(), rhs.Data(), rhs.GetSize());
 }
 
-template<typename Type>
-inline bool operator<=(const SimpleVector<Type> &lhs, const SimpleVector<Type> &rhs) {
+template<typename Type, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+inline SIMPLE_VECTOR_CONSTEXPR bool operator<=(const SimpleVector<Type, Allocator, GrowthPolicy, Instrumentation> &lhs,
+                                               const SimpleVector<Type, Allocator, GrowthPolicy, Instrumentation> &rhs) {
   return !(lhs > rhs);
 }
 
-template<typename Type>
-inline bool operator>(const SimpleVector<Type> &lhs, const SimpleVector<Type> &rhs) {
+template<typename Type, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+inline SIMPLE_VECTOR_CONSTEXPR bool operator>(const SimpleVector<Type, Allocator, GrowthPolicy, Instrumentation> &lhs,
+                                              const SimpleVector<Type, Allocator, GrowthPolicy, Instrumentation> &rhs) {
   return rhs < lhs;
 }
 
-template<typename Type>
-inline bool operator>=(const SimpleVector<Type> &lhs, const SimpleVector<Type> &rhs) {
+template<typename Type, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+inline SIMPLE_VECTOR_CONSTEXPR bool operator>=(const SimpleVector<Type, Allocator, GrowthPolicy, Instrumentation> &lhs,
+                                               const SimpleVector<Type, Allocator, GrowthPolicy, Instrumentation> &rhs) {
   return !(lhs < rhs);
 }
@@ -0,0 +1,500 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#include "array_ptr.h"
+#include "growth_policy.h"
+#include "memory_utils.h"
+#include "simd_compare.h"
+#include "simple_vector.h"
+
+// Вектор с тем же интерфейсом, что и SimpleVector, который хранит до N элементов
+// прямо в себе и выделяет память в куче, только когда элементов становится больше N.
+// При переходе в кучу вместимость растёт по политике GrowthPolicy, начиная с N
+template<typename Type, size_t N, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class SmallVector {
+  static_assert(N > 0, "SmallVector must have room for at least one inline element");
+
+  using AllocTraits = std::allocator_traits<Allocator>;
+
+ public:
+  using Iterator = Type *;
+  using ConstIterator = const Type *;
+  using AllocatorType = Allocator;
+  using GrowthPolicyType = GrowthPolicy;
+
+  SmallVector() noexcept(noexcept(Allocator())) = default;
+
+  explicit SmallVector(const Allocator &alloc) noexcept : heap_(alloc) {
+  }
+
+  // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+  explicit SmallVector(size_t size, const Allocator &alloc = Allocator()) : heap_(alloc) {
+    Reserve(size);
+    detail::UninitializedValueConstruct(heap_.GetAllocator(), Data(), Data() + size);
+    size_ = size;
+  }
+
+  explicit SmallVector(ReserveProxyObj reserve_proxy_obj, const Allocator &alloc = Allocator())
+      : heap_(alloc) {
+    Reserve(reserve_proxy_obj.GetReservedCapacity());
+  }
+
+  // Создаёт вектор из size элементов, инициализированных значением value
+  SmallVector(size_t size, const Type &value, const Allocator &alloc = Allocator()) : heap_(alloc) {
+    Reserve(size);
+    detail::UninitializedFill(heap_.GetAllocator(), Data(), Data() + size, value);
+    size_ = size;
+  }
+
+  // Создаёт вектор из std::initializer_list
+  SmallVector(std::initializer_list<Type> init, const Allocator &alloc = Allocator()) : heap_(alloc) {
+    Reserve(init.size());
+    detail::UninitializedCopy(heap_.GetAllocator(), init.begin(), init.end(), Data());
+    size_ = init.size();
+  }
+
+  SmallVector(const SmallVector &other)
+      : SmallVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+  }
+
+  // Создаёт копию other, память для которой при необходимости выделяется аллокатором alloc
+  SmallVector(const SmallVector &other, const Allocator &alloc) : heap_(alloc) {
+    Reserve(other.size_);
+    detail::UninitializedCopy(heap_.GetAllocator(), other.begin(), other.end(), Data());
+    size_ = other.size_;
+  }
+
+  // Память в куче забирается у other целиком, а встроенные элементы перемещаются по одному
+  SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<Type>)
+      : heap_(std::move(other.heap_)), size_(other.size_) {
+    if (IsInline()) {
+      detail::UninitializedMove(heap_.GetAllocator(), other.begin(), other.end(), Data());
+      other.Clear();
+    }
+    other.size_ = 0;
+  }
+
+  ~SmallVector() {
+    DestroyElements();
+  }
+
+  // Если вместимости хватает, память не выделяется: существующим элементам
+  // присваиваются значения элементов rhs, недостающие создаются, лишние разрушаются
+  SmallVector &operator=(const SmallVector &rhs) {
+    if (this == &rhs) {
+      return *this;
+    }
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+      if (GetAllocator() != rhs.GetAllocator()) {
+        Clear();
+        heap_.ReplaceAllocator(rhs.GetAllocator());
+      }
+    }
+    if (rhs.size_ > GetCapacity()) {
+      ArrayPtr<Type, Allocator> new_array(rhs.size_, heap_.GetAllocator());
+      detail::UninitializedCopy(new_array.GetAllocator(), rhs.begin(), rhs.end(), new_array.Get());
+      DestroyElements();
+      heap_.swap(new_array);
+    } else if (rhs.size_ <= size_) {
+      Type *new_end = std::copy(rhs.begin(), rhs.end(), Data());
+      detail::Destroy(heap_.GetAllocator(), new_end, end());
+    } else {
+      std::copy(rhs.begin(), rhs.begin() + size_, Data());
+      detail::UninitializedCopy(heap_.GetAllocator(), rhs.begin() + size_, rhs.end(), end());
+    }
+    size_ = rhs.size_;
+    return *this;
+  }
+
+  // Память в куче забирается у rhs, если аллокатор передаётся или аллокаторы равны.
+  // Иначе, а также когда rhs хранит элементы в себе, элементы перемещаются по одному.
+  // Передаваемый аллокатор забирается у rhs в обоих случаях
+  SmallVector &operator=(SmallVector &&rhs) noexcept(
+      std::is_nothrow_move_constructible_v<Type>
+      && (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)) {
+    if (this == &rhs) {
+      return *this;
+    }
+    Clear();
+    if (!rhs.IsInline() && (AllocTraits::propagate_on_container_move_assignment::value
+        || GetAllocator() == rhs.GetAllocator())) {
+      heap_ = std::move(rhs.heap_);
+      size_ = std::exchange(rhs.size_, 0);
+    } else {
+      if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+        heap_.ReplaceAllocator(rhs.GetAllocator());
+      }
+      Reserve(rhs.size_);
+      detail::UninitializedMove(heap_.GetAllocator(), rhs.begin(), rhs.end(), Data());
+      size_ = rhs.size_;
+      rhs.Clear();
+    }
+    return *this;
+  }
+
+  // Возвращает копию аллокатора вектора
+  Allocator GetAllocator() const noexcept {
+    return heap_.GetAllocator();
+  }
+
+  // Возвращает количество элементов в массиве
+  size_t GetSize() const noexcept {
+    return size_;
+  }
+
+  // Возвращает вместимость массива
+  size_t GetCapacity() const noexcept {
+    return IsInline() ? N : heap_.GetSize();
+  }
+
+  // Сообщает, хранятся ли элементы внутри самого вектора
+  bool IsInline() const noexcept {
+    return !heap_;
+  }
+
+  // Сообщает, пустой ли массив
+  bool IsEmpty() const noexcept {
+    return size_ == 0;
+  }
+
+  // Возвращает ссылку на элемент с индексом index
+  Type &operator[](size_t index) noexcept {
+    return Data()[index];
+  }
+
+  // Возвращает константную ссылку на элемент с индексом index
+  const Type &operator[](size_t index) const noexcept {
+    return Data()[index];
+  }
+
+  // Возвращает ссылку на элемент с индексом index
+  // Выбрасывает исключение std::out_of_range, если index >= size
+  Type &At(size_t index) {
+    if (index >= size_) {
+      throw std::out_of_range("out_of_range");
+    }
+    return Data()[index];
+  }
+
+  // Возвращает константную ссылку на элемент с индексом index
+  // Выбрасывает исключение std::out_of_range, если index >= size
+  const Type &At(size_t index) const {
+    if (index >= size_) {
+      throw std::out_of_range("out_of_range");
+    }
+    return Data()[index];
+  }
+
+  // Разрушает все элементы и обнуляет размер массива, не изменяя его вместимость
+  void Clear() noexcept {
+    DestroyElements();
+    size_ = 0;
+  }
+
+  // Изменяет размер массива.
+  // При уменьшении размера лишние элементы разрушаются.
+  // При увеличении размера новые элементы получают значение по умолчанию для типа Type
+  void Resize(size_t new_size) {
+    ResizeWith(new_size, [](Allocator &alloc, Type *first, Type *last) {
+      detail::UninitializedValueConstruct(alloc, first, last);
+    });
+  }
+
+  // Изменяет размер массива. Новые элементы создаются копиями value.
+  // value может быть элементом самого вектора
+  void Resize(size_t new_size, const Type &value) {
+    ResizeWith(new_size, [&value](Allocator &alloc, Type *first, Type *last) {
+      detail::UninitializedFill(alloc, first, last, value);
+    });
+  }
+
+  // Изменяет размер массива. Новые элементы инициализируются по умолчанию (как `new Type`),
+  // поэтому элементы тривиальных типов не обнуляются и содержат неопределённые значения
+  void ResizeDefaultInit(size_t new_size) {
+    ResizeWith(new_size, [](Allocator &alloc, Type *first, Type *last) {
+      detail::UninitializedDefaultConstruct(alloc, first, last);
+    });
+  }
+
+  // Изменяет размер массива, не записывая ничего в память новых элементов.
+  // Читать новые элементы до того, как им присвоены значения, нельзя
+  void ResizeUninitialized(size_t new_size) {
+    static_assert(std::is_trivially_default_constructible_v<Type>,
+                  "ResizeUninitialized requires a trivially default constructible type");
+    ResizeDefaultInit(new_size);
+  }
+
+  // Добавляет элемент в конец вектора
+  void PushBack(const Type &item) {
+    EmplaceBack(item);
+  }
+
+  void PushBack(Type &&item) {
+    EmplaceBack(std::move(item));
+  }
+
+  // Создаёт элемент из аргументов args прямо в конце вектора.
+  // Возвращает ссылку на созданный элемент
+  template<typename... Args>
+  Type &EmplaceBack(Args &&... args) {
+    if (size_ == GetCapacity()) {
+      ReallocateAndEmplace(size_, std::forward<Args>(args)...);
+    } else {
+      AllocTraits::construct(heap_.GetAllocator(), end(), std::forward<Args>(args)...);
+      ++size_;
+    }
+    return Data()[size_ - 1];
+  }
+
+  // Вставляет значение value в позицию pos.
+  // Возвращает итератор на вставленное значение
+  Iterator Insert(ConstIterator pos, const Type &value) {
+    return Emplace(pos, value);
+  }
+
+  Iterator Insert(ConstIterator pos, Type &&value) {
+    return Emplace(pos, std::move(value));
+  }
+
+  // Создаёт элемент из аргументов args в позиции pos.
+  // Возвращает итератор на созданный элемент
+  template<typename... Args>
+  Iterator Emplace(ConstIterator pos, Args &&... args) {
+    assert(pos >= cbegin() && pos <= cend());
+    const size_t index = std::distance(cbegin(), pos);
+    if (size_ == GetCapacity()) {
+      ReallocateAndEmplace(index, std::forward<Args>(args)...);
+    } else if (index == size_) {
+      AllocTraits::construct(heap_.GetAllocator(), end(), std::forward<Args>(args)...);
+      ++size_;
+    } else {
+      Type temp(std::forward<Args>(args)...);
+      AllocTraits::construct(heap_.GetAllocator(), end(), std::move(*(end() - 1)));
+      ++size_;
+      detail::MoveBackward(begin() + index, end() - 2, end() - 1);
+      Data()[index] = std::move(temp);
+    }
+    return begin() + index;
+  }
+
+  // Удаляет последний элемент вектора. Вектор не должен быть пустым
+  void PopBack() noexcept {
+    assert(!IsEmpty());
+    --size_;
+    AllocTraits::destroy(heap_.GetAllocator(), end());
+  }
+
+  // Удаляет элемент вектора в указанной позиции
+  Iterator Erase(ConstIterator pos) {
+    assert(pos >= begin() && pos < end());
+    const size_t index = std::distance(cbegin(), pos);
+    detail::MoveForward(begin() + index + 1, end(), begin() + index);
+    PopBack();
+    return begin() + index;
+  }
+
+  // Удаляет элементы [first, last). Хвост вектора сдвигается один раз
+  Iterator Erase(ConstIterator first, ConstIterator last) {
+    assert(first >= begin() && first <= last && last <= end());
+    const size_t first_index = std::distance(cbegin(), first);
+    const size_t last_index = std::distance(cbegin(), last);
+    if (first_index != last_index) {
+      detail::MoveForward(begin() + last_index, end(), begin() + first_index);
+      const size_t new_size = size_ - (last_index - first_index);
+      detail::Destroy(heap_.GetAllocator(), begin() + new_size, end());
+      size_ = new_size;
+    }
+    return begin() + first_index;
+  }
+
+  // Удаляет все элементы, для которых pred возвращает true, за один проход.
+  // Возвращает число удалённых элементов
+  template<typename Predicate>
+  size_t EraseIf(Predicate pred) {
+    Type *const new_end = std::remove_if(begin(), end(), [&pred](const Type &item) {
+      return pred(item);
+    });
+    const size_t removed = end() - new_end;
+    detail::Destroy(heap_.GetAllocator(), new_end, end());
+    size_ -= removed;
+    return removed;
+  }
+
+  // Удаляет элемент в позиции pos за O(1), перемещая на его место последний элемент
+  Iterator UnorderedErase(ConstIterator pos) {
+    assert(pos >= begin() && pos < end());
+    const size_t index = std::distance(cbegin(), pos);
+    if (index != size_ - 1) {
+      Data()[index] = std::move(Data()[size_ - 1]);
+    }
+    PopBack();
+    return begin() + index;
+  }
+
+  // Увеличивает вместимость вектора до new_capacity, перенося элементы в кучу.
+  // Если перенос элементов бросает исключение, вектор остаётся прежним
+  void Reserve(size_t new_capacity) {
+    if (new_capacity > GetCapacity()) {
+      ArrayPtr<Type, Allocator> new_array(new_capacity, heap_.GetAllocator());
+      detail::UninitializedRelocate(new_array.GetAllocator(), begin(), end(), new_array.Get());
+      DestroyElements();
+      heap_.swap(new_array);
+    }
+  }
+
+  // Обменивает значение с другим вектором.
+  // Если оба вектора хранят элементы в куче, обмениваются только указатели,
+  // иначе встроенные элементы перемещаются
+  void swap(SmallVector &other) noexcept(std::is_nothrow_move_constructible_v<Type>
+      && (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)) {
+    if (!IsInline() && !other.IsInline()) {
+      assert(AllocTraits::propagate_on_container_swap::value || GetAllocator() == other.GetAllocator());
+      heap_.swap(other.heap_);
+      std::swap(size_, other.size_);
+      return;
+    }
+    SmallVector temp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(temp);
+  }
+
+  Iterator begin() noexcept {
+    return Data();
+  }
+
+  Iterator end() noexcept {
+    return Data() + size_;
+  }
+
+  ConstIterator begin() const noexcept {
+    return Data();
+  }
+
+  ConstIterator end() const noexcept {
+    return Data() + size_;
+  }
+
+  ConstIterator cbegin() const noexcept {
+    return Data();
+  }
+
+  ConstIterator cend() const noexcept {
+    return Data() + size_;
+  }
+
+ private:
+  Type *Data() noexcept {
+    return IsInline() ? std::launder(reinterpret_cast<Type *>(inline_storage_)) : heap_.Get();
+  }
+
+  const Type *Data() const noexcept {
+    return IsInline() ? std::launder(reinterpret_cast<const Type *>(inline_storage_)) : heap_.Get();
+  }
+
+  // Вместимость, до которой нужно вырасти, чтобы вместить new_size элементов
+  size_t CalculateCapacity(size_t new_size) const noexcept {
+    return GrowthPolicy::NextCapacity(GetCapacity(), new_size, sizeof(Type));
+  }
+
+  // Изменяет размер массива, создавая новые элементы вызовом construct(alloc, first, last).
+  // При переносе в кучу новые элементы создаются до переноса существующих,
+  // так как construct может ссылаться на элементы вектора.
+  // Если создание или перенос бросает исключение, вектор остаётся прежним
+  template<typename ConstructFn>
+  void ResizeWith(size_t new_size, ConstructFn construct) {
+    if (new_size <= size_) {
+      detail::Destroy(heap_.GetAllocator(), begin() + new_size, end());
+      size_ = new_size;
+      return;
+    }
+    if (new_size > GetCapacity()) {
+      ArrayPtr<Type, Allocator> new_array(CalculateCapacity(new_size), heap_.GetAllocator());
+      auto &alloc = new_array.GetAllocator();
+      Type *const new_data = new_array.Get();
+      construct(alloc, new_data + size_, new_data + new_size);
+      detail::ConstructionGuard appended(alloc, new_data + size_, new_data + new_size);
+      detail::UninitializedRelocate(alloc, begin(), end(), new_data);
+      appended.Release();
+      DestroyElements();
+      heap_.swap(new_array);
+    } else {
+      construct(heap_.GetAllocator(), end(), begin() + new_size);
+    }
+    size_ = new_size;
+  }
+
+  // Выделяет память в куче, создаёт в ней элемент из args в позиции index
+  // и переносит вокруг него существующие элементы.
+  // Если создание или перенос бросает исключение, вектор остаётся прежним
+  template<typename... Args>
+  void ReallocateAndEmplace(size_t index, Args &&... args) {
+    ArrayPtr<Type, Allocator> new_array(CalculateCapacity(size_ + 1), heap_.GetAllocator());
+    auto &alloc = new_array.GetAllocator();
+    Type *const new_data = new_array.Get();
+
+    detail::ConstructionGuard emplaced(alloc, new_data + index);
+    AllocTraits::construct(alloc, emplaced.Current(), std::forward<Args>(args)...);
+    emplaced.Advance();
+
+    detail::ConstructionGuard prefix(alloc, new_data,
+                                     detail::UninitializedRelocate(alloc, begin(), begin() + index, new_data));
+    detail::UninitializedRelocate(alloc, begin() + index, end(), new_data + index + 1);
+    prefix.Release();
+    emplaced.Release();
+
+    DestroyElements();
+    heap_.swap(new_array);
+    ++size_;
+  }
+
+  void DestroyElements() noexcept {
+    detail::Destroy(heap_.GetAllocator(), begin(), end());
+  }
+
+  // Память в куче; пуста, пока элементы помещаются во встроенный буфер
+  ArrayPtr<Type, Allocator> heap_;
+  size_t size_ = 0;
+  alignas(Type) unsigned char inline_storage_[N * sizeof(Type)];
+};
+
+template<typename Type, size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator==(const SmallVector<Type, N, Allocator, GrowthPolicy> &lhs,
+                       const SmallVector<Type, N, Allocator, GrowthPolicy> &rhs) {
+  return lhs.GetSize() == rhs.GetSize() && detail::RangesEqual(lhs.begin(), rhs.begin(), lhs.GetSize());
+}
+
+template<typename Type, size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator!=(const SmallVector<Type, N, Allocator, GrowthPolicy> &lhs,
+                       const SmallVector<Type, N, Allocator, GrowthPolicy> &rhs) {
+  return !(lhs == rhs);
+}
+
+template<typename Type, size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator<(const SmallVector<Type, N, Allocator, GrowthPolicy> &lhs,
+                      const SmallVector<Type, N, Allocator, GrowthPolicy> &rhs) {
+  return detail::LexicographicalLess(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
+}
+
+template<typename Type, size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator<=(const SmallVector<Type, N, Allocator, GrowthPolicy> &lhs,
+                       const SmallVector<Type, N, Allocator, GrowthPolicy> &rhs) {
+  return !(lhs > rhs);
+}
+
+template<typename Type, size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator>(const SmallVector<Type, N, Allocator, GrowthPolicy> &lhs,
+                      const SmallVector<Type, N, Allocator, GrowthPolicy> &rhs) {
+  return rhs < lhs;
+}
+
+template<typename Type, size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator>=(const SmallVector<Type, N, Allocator, GrowthPolicy> &lhs,
+                       const SmallVector<Type, N, Allocator, GrowthPolicy> &rhs) {
+  return !(lhs < rhs);
+}
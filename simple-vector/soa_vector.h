@@ -0,0 +1,491 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "aligned_allocator.h"
+#include "array_ptr.h"
+#include "checked_iterator.h"
+#include "growth_policy.h"
+#include "index_iterator.h"
+#include "memory_utils.h"
+#include "simd_compare.h"
+#include "simple_span.h"
+
+namespace detail {
+
+// Вызывает fn(std::integral_constant<size_t, I>()) для I из Is по порядку
+template<typename Fn, size_t... Is>
+void ForEachIndex(Fn &&fn, std::index_sequence<Is...>) {
+  (fn(std::integral_constant<size_t, Is>()), ...);
+}
+
+}  // namespace detail
+
+// Вектор записей из полей Fields..., хранящий каждое поле в отдельном непрерывном
+// массиве (structure of arrays). Цикл, читающий одно поле, проходит только по его
+// массиву и не тратит пропускную способность памяти на остальные поля.
+// Массивы полей - ArrayPtr с одинаковой вместимостью, которая растёт по GrowthPolicy
+// (размер элемента для политики - сумма размеров полей).
+// Память под поле Field выделяет аллокатор Allocator, приведённый к Field (rebind).
+// Доступ к строке - кортеж ссылок на её поля; Column<I>() даёт массив поля I целиком
+template<typename Allocator, typename GrowthPolicy, typename... Fields>
+class BasicSoAVector {
+  static_assert(sizeof...(Fields) > 0, "SoAVector needs at least one field");
+
+  using AllocTraits = std::allocator_traits<Allocator>;
+
+  template<typename Field>
+  using FieldAllocator = typename AllocTraits::template rebind_alloc<Field>;
+
+  using Columns = std::tuple<ArrayPtr<Fields, FieldAllocator<Fields>>...>;
+  using Indices = std::index_sequence_for<Fields...>;
+
+  static constexpr size_t kRowSize = (sizeof(Fields) + ...);
+
+ public:
+  using ValueType = std::tuple<Fields...>;
+  using Reference = std::tuple<Fields &...>;
+  using ConstReference = std::tuple<const Fields &...>;
+  using Iterator = detail::IndexIterator<BasicSoAVector, Reference>;
+  using ConstIterator = detail::IndexIterator<const BasicSoAVector, ConstReference>;
+  using AllocatorType = Allocator;
+  using GrowthPolicyType = GrowthPolicy;
+
+  // Тип поля с номером I
+  template<size_t I>
+  using FieldType = std::tuple_element_t<I, ValueType>;
+
+  static constexpr size_t kFieldCount = sizeof...(Fields);
+
+  BasicSoAVector() = default;
+
+  explicit BasicSoAVector(const Allocator &alloc) noexcept : columns_(FieldAllocator<Fields>(alloc)...) {
+  }
+
+  // Создаёт вектор из size строк, поля которых инициализированы значением по умолчанию
+  explicit BasicSoAVector(size_t size, const Allocator &alloc = Allocator()) : BasicSoAVector(alloc) {
+    Resize(size);
+  }
+
+  BasicSoAVector(const BasicSoAVector &other)
+      : BasicSoAVector(other, AllocTraits::select_on_container_copy_construction(
+          other.GetAllocator())) {
+  }
+
+  // Создаёт копию other, память для которой выделяется аллокатором alloc
+  BasicSoAVector(const BasicSoAVector &other, const Allocator &alloc)
+      : columns_(ArrayPtr<Fields, FieldAllocator<Fields>>(other.size_, FieldAllocator<Fields>(alloc))...) {
+    ConstructColumns(columns_, 0, other.size_, [&](auto &column, auto i) {
+      const auto *source = std::get<i>(other.columns_).Get();
+      detail::UninitializedCopy(column.GetAllocator(), source, source + other.size_, column.Get());
+    });
+    size_ = other.size_;
+  }
+
+  BasicSoAVector(BasicSoAVector &&other) noexcept
+      : columns_(std::move(other.columns_)), size_(std::exchange(other.size_, 0)) {
+  }
+
+  ~BasicSoAVector() {
+    Clear();
+  }
+
+  // Аллокатор заменяется аллокатором rhs, только если этого требует
+  // propagate_on_container_copy_assignment
+  BasicSoAVector &operator=(const BasicSoAVector &rhs) {
+    if (this == &rhs) {
+      return *this;
+    }
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+      if (GetAllocator() != rhs.GetAllocator()) {
+        // Память, выделенную старым аллокатором, нужно освободить им же
+        Clear();
+        const Allocator alloc = rhs.GetAllocator();
+        ForEachColumn(columns_, [&](auto &column, auto i) {
+          column.ReplaceAllocator(FieldAllocator<FieldType<i>>(alloc));
+        });
+      }
+    }
+    BasicSoAVector copy(rhs, GetAllocator());
+    swap(copy);
+    return *this;
+  }
+
+  // Если аллокатор не передаётся (propagate_on_container_move_assignment == false)
+  // и аллокаторы не равны, забрать память rhs нельзя, и строки перемещаются по одной
+  BasicSoAVector &operator=(BasicSoAVector &&rhs) noexcept(
+      AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+    if (this == &rhs) {
+      return *this;
+    }
+    if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+        && !AllocTraits::is_always_equal::value) {
+      if (GetAllocator() != rhs.GetAllocator()) {
+        Clear();
+        Reserve(rhs.size_);
+        ConstructColumns(columns_, 0, rhs.size_, [&](auto &column, auto i) {
+          auto *source = std::get<i>(rhs.columns_).Get();
+          detail::UninitializedMove(column.GetAllocator(), source, source + rhs.size_, column.Get());
+        });
+        size_ = rhs.size_;
+        rhs.Clear();
+        return *this;
+      }
+    }
+    Clear();
+    columns_ = std::move(rhs.columns_);
+    size_ = std::exchange(rhs.size_, 0);
+    return *this;
+  }
+
+  // Возвращает копию аллокатора вектора
+  Allocator GetAllocator() const noexcept {
+    return Allocator(std::get<0>(columns_).GetAllocator());
+  }
+
+  // Возвращает количество строк
+  size_t GetSize() const noexcept {
+    return size_;
+  }
+
+  // Возвращает вместимость: число строк, под которые выделена память каждого поля
+  size_t GetCapacity() const noexcept {
+    return std::get<0>(columns_).GetSize();
+  }
+
+  bool IsEmpty() const noexcept {
+    return size_ == 0;
+  }
+
+  // Возвращает кортеж ссылок на поля строки index
+  Reference operator[](size_t index) SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(index < size_, "index is out of range");
+    return MakeReference(index, Indices());
+  }
+
+  ConstReference operator[](size_t index) const SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(index < size_, "index is out of range");
+    return MakeReference(index, Indices());
+  }
+
+  // Возвращает кортеж ссылок на поля строки index
+  // Выбрасывает исключение std::out_of_range, если index >= size
+  Reference At(size_t index) {
+    if (index >= size_) {
+      throw std::out_of_range("out_of_range");
+    }
+    return MakeReference(index, Indices());
+  }
+
+  ConstReference At(size_t index) const {
+    if (index >= size_) {
+      throw std::out_of_range("out_of_range");
+    }
+    return MakeReference(index, Indices());
+  }
+
+  // Возвращает ссылку на поле I строки index
+  template<size_t I>
+  FieldType<I> &Get(size_t index) SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(index < size_, "index is out of range");
+    return std::get<I>(columns_)[index];
+  }
+
+  template<size_t I>
+  const FieldType<I> &Get(size_t index) const SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(index < size_, "index is out of range");
+    return std::get<I>(columns_)[index];
+  }
+
+  // Возвращает массив поля I всех строк
+  template<size_t I>
+  SimpleSpan<FieldType<I>> Column() noexcept {
+    return SimpleSpan<FieldType<I>>(std::get<I>(columns_).Get(), size_);
+  }
+
+  template<size_t I>
+  SimpleSpan<const FieldType<I>> Column() const noexcept {
+    return SimpleSpan<const FieldType<I>>(std::get<I>(columns_).Get(), size_);
+  }
+
+  // Возвращает указатель на массив поля I, сообщая компилятору выравнивание,
+  // которое гарантирует аллокатор (например, AlignedAllocator)
+  template<size_t I>
+  FieldType<I> *AlignedColumnData() noexcept {
+    return AssumeAligned<detail::kAllocatorAlignment<FieldAllocator<FieldType<I>>>>(std::get<I>(columns_).Get());
+  }
+
+  template<size_t I>
+  const FieldType<I> *AlignedColumnData() const noexcept {
+    return AssumeAligned<detail::kAllocatorAlignment<FieldAllocator<FieldType<I>>>>(
+        static_cast<const FieldType<I> *>(std::get<I>(columns_).Get()));
+  }
+
+  // Разрушает все строки, не изменяя вместимость
+  void Clear() noexcept {
+    DestroyRows(columns_, 0, size_);
+    size_ = 0;
+  }
+
+  // Изменяет число строк. Поля новых строк инициализируются значением по умолчанию
+  void Resize(size_t new_size) {
+    if (new_size < size_) {
+      DestroyRows(columns_, new_size, size_);
+      size_ = new_size;
+      return;
+    }
+    if (new_size > GetCapacity()) {
+      Reserve(CalculateCapacity(new_size));
+    }
+    ConstructColumns(columns_, size_, new_size, [&](auto &column, auto) {
+      detail::UninitializedValueConstruct(column.GetAllocator(), column.Get() + size_, column.Get() + new_size);
+    });
+    size_ = new_size;
+  }
+
+  // Добавляет строку с полями из кортежа row
+  void PushBack(const ValueType &row) {
+    std::apply([this](const Fields &... fields) { EmplaceBack(fields...); }, row);
+  }
+
+  void PushBack(ValueType &&row) {
+    std::apply([this](Fields &... fields) { EmplaceBack(std::move(fields)...); }, row);
+  }
+
+  // Добавляет строку, создавая каждое поле из своего аргумента.
+  // Возвращает кортеж ссылок на поля созданной строки
+  template<typename... Args>
+  Reference EmplaceBack(Args &&... args) {
+    static_assert(sizeof...(Args) == sizeof...(Fields), "EmplaceBack takes one argument per field");
+    if (size_ == GetCapacity()) {
+      // Аргументы могут ссылаться на поля вектора, которые переместятся при перевыделении
+      ValueType row(std::forward<Args>(args)...);
+      Reserve(CalculateCapacity(size_ + 1));
+      ConstructRow(size_, std::move(row));
+    } else {
+      ConstructRow(size_, std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    ++size_;
+    return MakeReference(size_ - 1, Indices());
+  }
+
+  // Удаляет последнюю строку. Вектор не должен быть пустым
+  void PopBack() SIMPLE_VECTOR_CHECKED_NOEXCEPT {
+    detail::Check(!IsEmpty(), "PopBack of empty vector");
+    assert(!IsEmpty());
+    --size_;
+    DestroyRows(columns_, size_, size_ + 1);
+  }
+
+  // Удаляет строку в позиции pos, сдвигая следующие строки
+  Iterator Erase(ConstIterator pos) {
+    const size_t index = pos.GetIndex();
+    detail::Check(index < size_, "Erase of end()");
+    assert(index < size_);
+    ForEachColumn(columns_, [&](auto &column, auto) {
+      detail::MoveForward(column.Get() + index + 1, column.Get() + size_, column.Get() + index);
+    });
+    PopBack();
+    return begin() + index;
+  }
+
+  // Увеличивает вместимость всех полей до new_capacity.
+  // Если перенос какого-либо поля бросает исключение, вектор остаётся прежним
+  void Reserve(size_t new_capacity) {
+    if (new_capacity > GetCapacity()) {
+      Reallocate(new_capacity);
+    }
+  }
+
+  // Уменьшает вместимость до числа строк
+  void ShrinkToFit() {
+    if (size_ == GetCapacity()) {
+      return;
+    }
+    if (size_ == 0) {
+      ForEachColumn(columns_, [](auto &column, auto) {
+        column.Reset();
+      });
+      return;
+    }
+    Reallocate(size_);
+  }
+
+  // Разрушает все строки и освобождает память
+  void Reset() noexcept {
+    Clear();
+    ForEachColumn(columns_, [](auto &column, auto) {
+      column.Reset();
+    });
+  }
+
+  // Обменивает значение с другим вектором
+  void swap(BasicSoAVector &other) noexcept {
+    SwapColumns(columns_, other.columns_);
+    std::swap(size_, other.size_);
+  }
+
+  // Итераторы по строкам. Разыменование возвращает кортеж ссылок на поля
+  Iterator begin() noexcept {
+    return Iterator(this, 0);
+  }
+
+  Iterator end() noexcept {
+    return Iterator(this, size_);
+  }
+
+  ConstIterator begin() const noexcept {
+    return ConstIterator(this, 0);
+  }
+
+  ConstIterator end() const noexcept {
+    return ConstIterator(this, size_);
+  }
+
+  ConstIterator cbegin() const noexcept {
+    return begin();
+  }
+
+  ConstIterator cend() const noexcept {
+    return end();
+  }
+
+ private:
+  // Вызывает fn(column, index) для каждого поля, где index - std::integral_constant с его номером
+  template<typename Fn>
+  static void ForEachColumn(Columns &columns, Fn fn) {
+    detail::ForEachIndex([&](auto i) {
+      fn(std::get<i>(columns), i);
+    }, Indices());
+  }
+
+  // Заполняет поля строк [first, last) вызовами construct(column, index) по порядку полей.
+  // Если construct бросает исключение, строки [first, last) уже заполненных полей
+  // разрушаются, и исключение передаётся дальше
+  template<typename ConstructFn>
+  static void ConstructColumns(Columns &columns, size_t first, size_t last, ConstructFn construct) {
+    size_t constructed = 0;
+    try {
+      ForEachColumn(columns, [&](auto &column, auto i) {
+        construct(column, i);
+        ++constructed;
+      });
+    } catch (...) {
+      ForEachColumn(columns, [&](auto &column, auto i) {
+        if (i < constructed) {
+          detail::Destroy(column.GetAllocator(), column.Get() + first, column.Get() + last);
+        }
+      });
+      throw;
+    }
+  }
+
+  static void DestroyRows(Columns &columns, size_t first, size_t last) noexcept {
+    ForEachColumn(columns, [&](auto &column, auto) {
+      detail::Destroy(column.GetAllocator(), column.Get() + first, column.Get() + last);
+    });
+  }
+
+  static void SwapColumns(Columns &lhs, Columns &rhs) noexcept {
+    ForEachColumn(lhs, [&](auto &column, auto i) {
+      column.swap(std::get<i>(rhs));
+    });
+  }
+
+  template<size_t... Is>
+  Reference MakeReference(size_t index, std::index_sequence<Is...>) noexcept {
+    return Reference(std::get<Is>(columns_)[index]...);
+  }
+
+  template<size_t... Is>
+  ConstReference MakeReference(size_t index, std::index_sequence<Is...>) const noexcept {
+    return ConstReference(std::get<Is>(columns_)[index]...);
+  }
+
+  // Создаёт поля строки index из элементов кортежа args
+  template<typename Args>
+  void ConstructRow(size_t index, Args &&args) {
+    ConstructColumns(columns_, index, index + 1, [&](auto &column, auto i) {
+      std::allocator_traits<std::remove_reference_t<decltype(column.GetAllocator())>>::construct(
+          column.GetAllocator(), column.Get() + index, std::get<i>(std::forward<Args>(args)));
+    });
+  }
+
+  size_t CalculateCapacity(size_t new_size) const noexcept {
+    return GrowthPolicy::NextCapacity(GetCapacity(), new_size, kRowSize);
+  }
+
+  // Выделяет память под new_capacity строк для всех полей сразу и переносит в неё строки
+  // (см. detail::UninitializedRelocate). Сначала копируются поля, перемещение которых может
+  // бросить исключение, и только затем перемещаются остальные. Поэтому, если копирование поля
+  // бросает исключение, перенесённые поля разрушаются в новой памяти, а старые остаются нетронутыми
+  void Reallocate(size_t new_capacity) {
+    const Allocator alloc = GetAllocator();
+    Columns new_columns(ArrayPtr<Fields, FieldAllocator<Fields>>(new_capacity, FieldAllocator<Fields>(alloc))...);
+    bool relocated[kFieldCount] = {};
+    auto relocate = [&](auto &column, auto i) {
+      auto &old_column = std::get<i>(columns_);
+      detail::UninitializedRelocate(column.GetAllocator(), old_column.Get(), old_column.Get() + size_, column.Get());
+      relocated[i] = true;
+    };
+    try {
+      ForEachColumn(new_columns, [&](auto &column, auto i) {
+        if constexpr (detail::kRelocatesByCopy<FieldType<i>>) {
+          relocate(column, i);
+        }
+      });
+      ForEachColumn(new_columns, [&](auto &column, auto i) {
+        if constexpr (!detail::kRelocatesByCopy<FieldType<i>>) {
+          relocate(column, i);
+        }
+      });
+    } catch (...) {
+      ForEachColumn(new_columns, [&](auto &column, auto i) {
+        if (relocated[i]) {
+          detail::Destroy(column.GetAllocator(), column.Get(), column.Get() + size_);
+        }
+      });
+      throw;
+    }
+    DestroyRows(columns_, 0, size_);
+    SwapColumns(columns_, new_columns);
+  }
+
+  Columns columns_;
+  size_t size_ = 0;
+};
+
+// SoA-вектор со стандартным аллокатором
+template<typename... Fields>
+using SoAVector = BasicSoAVector<std::allocator<std::byte>, DoublingGrowth, Fields...>;
+
+// SoA-вектор, массив каждого поля которого выровнен по кэш-линии
+template<typename... Fields>
+using AlignedSoAVector = BasicSoAVector<AlignedAllocator<std::byte>, DoublingGrowth, Fields...>;
+
+// Векторы равны, если равны их массивы всех полей
+template<typename Allocator, typename GrowthPolicy, typename... Fields>
+bool operator==(const BasicSoAVector<Allocator, GrowthPolicy, Fields...> &lhs,
+                const BasicSoAVector<Allocator, GrowthPolicy, Fields...> &rhs) {
+  if (lhs.GetSize() != rhs.GetSize()) {
+    return false;
+  }
+  bool equal = true;
+  detail::ForEachIndex([&](auto i) {
+    equal = equal && detail::RangesEqual(lhs.template Column<i>().Data(), rhs.template Column<i>().Data(),
+                                         lhs.GetSize());
+  }, std::index_sequence_for<Fields...>());
+  return equal;
+}
+
+template<typename Allocator, typename GrowthPolicy, typename... Fields>
+bool operator!=(const BasicSoAVector<Allocator, GrowthPolicy, Fields...> &lhs,
+                const BasicSoAVector<Allocator, GrowthPolicy, Fields...> &rhs) {
+  return !(lhs == rhs);
+}
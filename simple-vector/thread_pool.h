@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Пул потоков с общей очередью задач
+class ThreadPool {
+ public:
+  // Создаёт пул из thread_count потоков (по умолчанию - по числу аппаратных потоков)
+  explicit ThreadPool(size_t thread_count = std::max(1u, std::thread::hardware_concurrency())) {
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+      workers_.emplace_back([this] {
+        WorkerLoop();
+      });
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Дожидается выполнения всех поставленных задач и останавливает потоки
+  ~ThreadPool() {
+    {
+      std::lock_guard lock(mutex_);
+      stopped_ = true;
+    }
+    has_tasks_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // Общий пул программы, создаётся при первом обращении
+  static ThreadPool &Default() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  size_t GetThreadCount() const noexcept {
+    return workers_.size();
+  }
+
+  // Ставит задачу в очередь. Задача не должна бросать исключений
+  void Submit(std::function<void()> task) {
+    {
+      std::lock_guard lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    has_tasks_.notify_one();
+  }
+
+ private:
+  void WorkerLoop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock lock(mutex_);
+        has_tasks_.wait(lock, [this] {
+          return stopped_ || !tasks_.empty();
+        });
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable has_tasks_;
+  std::deque<std::function<void()>> tasks_;
+  bool stopped_ = false;
+  std::vector<std::thread> workers_;
+};
+
+namespace detail {
+
+// Общее состояние одного вызова ParallelFor. Хранится в shared_ptr, потому что
+// задача пула может начаться уже после того, как все части обработаны и ParallelFor вернул управление
+struct ParallelForState {
+  std::atomic<size_t> next_chunk = 0;
+  size_t chunk_count = 0;
+  size_t completed_chunks = 0;
+  std::exception_ptr exception;
+  std::mutex mutex;
+  std::condition_variable done;
+};
+
+}  // namespace detail
+
+// Делит [0, count) на части по chunk_size индексов и вызывает function(begin, end) для каждой части.
+// Потоки пула и вызывающий поток забирают следующую часть из общего атомарного счётчика,
+// поэтому освободившийся поток сразу берёт новую работу, а вложенный вызов из задачи пула
+// не блокируется: если свободных потоков нет, все части обработает вызывающий поток.
+// Исключение, брошенное function, передаётся вызывающему потоку после обработки всех частей
+template<typename Function>
+void ParallelFor(ThreadPool &pool, size_t count, size_t chunk_size, Function function) {
+  if (count == 0) {
+    return;
+  }
+  chunk_size = std::max<size_t>(chunk_size, 1);
+  const size_t chunk_count = (count - 1) / chunk_size + 1;
+  if (chunk_count == 1) {
+    function(size_t{0}, count);
+    return;
+  }
+
+  auto state = std::make_shared<detail::ParallelForState>();
+  state->chunk_count = chunk_count;
+  // Задача пула держит state и обращается к function, только пока есть необработанные части
+  auto work = [state, count, chunk_size, &function] {
+    size_t completed = 0;
+    std::exception_ptr exception;
+    for (size_t chunk; (chunk = state->next_chunk.fetch_add(1, std::memory_order_relaxed)) < state->chunk_count;) {
+      const size_t begin = chunk * chunk_size;
+      if (!exception) {
+        try {
+          function(begin, std::min(begin + chunk_size, count));
+        } catch (...) {
+          exception = std::current_exception();
+        }
+      }
+      ++completed;
+    }
+    if (completed == 0) {
+      return;
+    }
+    std::lock_guard lock(state->mutex);
+    if (exception && !state->exception) {
+      state->exception = exception;
+    }
+    state->completed_chunks += completed;
+    if (state->completed_chunks == state->chunk_count) {
+      state->done.notify_one();
+    }
+  };
+
+  const size_t helper_count = std::min(pool.GetThreadCount(), chunk_count - 1);
+  for (size_t i = 0; i < helper_count; ++i) {
+    pool.Submit(work);
+  }
+  work();
+
+  std::unique_lock lock(state->mutex);
+  state->done.wait(lock, [&state] {
+    return state->completed_chunks == state->chunk_count;
+  });
+  if (state->exception) {
+    std::rethrow_exception(state->exception);
+  }
+}
+
+// То же, что ParallelFor(pool, ...), с общим пулом программы
+template<typename Function>
+void ParallelFor(size_t count, size_t chunk_size, Function function) {
+  ParallelFor(ThreadPool::Default(), count, chunk_size, std::move(function));
+}
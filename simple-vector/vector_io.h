@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <system_error>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "serialization.h"
+
+// Ввод-вывод с разбросом и сборкой (readv/writev) прямо в память векторов, без
+// промежуточных буферов: несколько векторов читаются или записываются одним системным вызовом.
+// Для записи подходит любой буфер тривиально копируемых элементов с GetSize() и begin():
+// SimpleVector, SmallVector, SimpleSpan, MappedVector. Для чтения буфер должен также
+// поддерживать Reserve() и ResizeUninitialized(): SimpleVector, SmallVector, MappedVector
+
+// Место для чтения: до count элементов, которые дописываются в конец vector.
+// Создаётся функцией ReadInto
+template<typename Vector>
+struct ReadTarget {
+  Vector &vector;
+  size_t count;
+};
+
+// Прочитанные элементы будут дописаны в конец vector, но не больше count элементов
+template<typename Vector>
+ReadTarget<Vector> ReadInto(Vector &vector, size_t count) noexcept {
+  return {vector, count};
+}
+
+namespace detail {
+
+// Описание памяти элементов buffer для записи
+template<typename Buffer>
+iovec MakeWriteIoVector(const Buffer &buffer) noexcept {
+  RequireSerializable<Buffer>();
+  return {const_cast<void *>(static_cast<const void *>(ToAddress(buffer.begin()))),
+          buffer.GetSize() * sizeof(VectorValueType<Buffer>)};
+}
+
+// Резервирует память под target.count элементов за концом вектора и возвращает её описание.
+// Размер вектора не меняется, пока не известно, сколько байт прочитано
+template<typename Vector>
+iovec MakeReadIoVector(const ReadTarget<Vector> &target) {
+  RequireSerializable<Vector>();
+  Vector &v = target.vector;
+  v.Reserve(v.GetSize() + target.count);
+  return {ToAddress(v.begin()) + v.GetSize(), target.count * sizeof(VectorValueType<Vector>)};
+}
+
+// Увеличивает размер вектора на число целых элементов, уместившихся в первые из bytes_left
+// прочитанных байт, и уменьшает bytes_left на число байт, пришедшихся на этот вектор.
+// Байты неполного последнего элемента остаются за концом вектора
+template<typename Vector>
+void CommitRead(const ReadTarget<Vector> &target, size_t &bytes_left) {
+  constexpr size_t kElementSize = sizeof(VectorValueType<Vector>);
+  const size_t bytes = std::min(bytes_left, target.count * kElementSize);
+  bytes_left -= bytes;
+  target.vector.ResizeUninitialized(target.vector.GetSize() + bytes / kElementSize);
+}
+
+// Повторяет системный вызов call, пока он прерывается сигналом.
+// Бросает std::system_error, если вызов завершился ошибкой
+template<typename Call>
+size_t RetryOnInterrupt(const char *operation, Call call) {
+  while (true) {
+    const ssize_t result = call();
+    if (result >= 0) {
+      return static_cast<size_t>(result);
+    }
+    if (errno != EINTR) {
+      throw std::system_error(errno, std::generic_category(), operation);
+    }
+  }
+}
+
+}  // namespace detail
+
+// Записывает элементы буферов в fd одним вызовом writev, по порядку.
+// Возвращает число записанных байт, которое может быть меньше суммарного размера буферов.
+// Бросает std::system_error при ошибке записи
+template<typename... Buffers>
+size_t WriteVectored(int fd, const Buffers &... buffers) {
+  static_assert(sizeof...(Buffers) > 0 && sizeof...(Buffers) <= IOV_MAX, "unsupported number of buffers");
+  const std::array<iovec, sizeof...(Buffers)> io{detail::MakeWriteIoVector(buffers)...};
+  return detail::RetryOnInterrupt("writev", [&] {
+    return ::writev(fd, io.data(), static_cast<int>(io.size()));
+  });
+}
+
+// Читает из fd одним вызовом readv, заполняя места для чтения по порядку.
+// Память под элементы резервируется заранее, а размер каждого вектора увеличивается
+// на число прочитанных в него целых элементов. Возвращает число прочитанных байт;
+// 0 означает конец файла. Все векторы должны быть разными.
+// Бросает std::system_error при ошибке чтения; размеры векторов тогда не меняются
+template<typename... Vectors>
+size_t ReadVectored(int fd, const ReadTarget<Vectors> &... targets) {
+  static_assert(sizeof...(Vectors) > 0 && sizeof...(Vectors) <= IOV_MAX, "unsupported number of buffers");
+  const std::array<iovec, sizeof...(Vectors)> io{detail::MakeReadIoVector(targets)...};
+  const size_t bytes = detail::RetryOnInterrupt("readv", [&] {
+    return ::readv(fd, io.data(), static_cast<int>(io.size()));
+  });
+  size_t bytes_left = bytes;
+  (detail::CommitRead(targets, bytes_left), ...);
+  return bytes;
+}